@@ -1,12 +1,15 @@
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <sstream>
 
 #include <boost/foreach.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/ref.hpp>
 
 #include "succinct/mapper.hpp"
 
@@ -16,9 +19,20 @@
 #include "tries/hollow_trie.hpp"
 #include "tries/centroid_hollow_trie.hpp"
 #include "tries/path_decomposed_trie.hpp"
+#include "tries/packed_path_decomposed_trie.hpp"
+#include "tries/hybrid_trie.hpp"
+#include "tries/cached_trie.hpp"
+#include "tries/filtered_trie.hpp"
+#include "tries/remapped_trie.hpp"
+#include "tries/trie_map.hpp"
+#include "tries/value_codecs.hpp"
+#include "tries/dfa.hpp"
+#include "tries/dictionary_scanner.hpp"
 
 #include "tries/vbyte_string_pool.hpp"
 #include "tries/compressed_string_pool.hpp"
+#include "tries/fsst_string_pool.hpp"
+#include "tries/two_tier_string_pool.hpp"
 
 #include "perftest_common.hpp"
 
@@ -164,6 +178,467 @@ public:
     }
 };
 
+template <typename Trie>
+class benchmark_trie_batch : public benchmark_trie_2way<Trie>
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string sample_filename, std::vector<std::string> args)
+    {
+        benchmark_trie_2way<Trie>::measure(benchmark_name, filename, sample_filename, args);
+	succinct::util::mmap_lines sample_lines(sample_filename);
+	std::vector<std::string> strings_sample(sample_lines.begin(), sample_lines.end());
+
+        boost::iostreams::mapped_file_source m(filename);
+        Trie trie;
+        succinct::mapper::map(trie, m, succinct::mapper::map_flags::warmup);
+
+        std::vector<size_t> ids;
+        size_t in_flight_sizes[] = {1, 2, 4, 8, 16, 32, 64};
+        for (size_t i = 0; i < sizeof(in_flight_sizes) / sizeof(in_flight_sizes[0]); ++i) {
+            std::ostringstream msg;
+            msg << benchmark_name << " - batch queries - in flight " << in_flight_sizes[i];
+            TIMEIT(msg.str(), strings_sample.size()) {
+                trie.index_batch(strings_sample, ids, succinct::tries::stl_string_adaptor(), in_flight_sizes[i]);
+            }
+        }
+
+        size_t scan_size = std::min(trie.size(), size_t(1000000));
+        volatile size_t foo;
+        TIMEIT(benchmark_name + " - sequential scan - operator[]", scan_size) {
+            for (size_t i = 0; i < scan_size; ++i) {
+                foo = trie[i].size();
+            }
+        }
+
+        TIMEIT(benchmark_name + " - sequential scan - key_enumerator", scan_size) {
+            typename Trie::key_enumerator e = trie.get_key_enumerator();
+            for (size_t i = 0; i < scan_size; ++i) {
+                foo = e.next().size();
+            }
+        }
+
+        std::vector<size_t> indices(scan_size);
+        for (size_t i = 0; i < scan_size; ++i) {
+            indices[i] = (rand() * RAND_MAX + rand()) % trie.size();
+        }
+
+        TIMEIT(benchmark_name + " - random reverse lookups - operator[]", indices.size()) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                foo = trie[indices[i]].size();
+            }
+        }
+
+        char buf[1024];
+        TIMEIT(benchmark_name + " - random reverse lookups - get_key", indices.size()) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                foo = trie.get_key(indices[i], buf, sizeof(buf));
+            }
+        }
+        return 0;
+    }
+};
+
+
+// Compares trie traversal with a linear scan of the strings for glob
+// patterns; measure takes the strings file in place of the sample and
+// the patterns as extra arguments
+template <typename Trie>
+class benchmark_trie_match : public benchmark_trie_index<Trie>
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string strings_filename, std::vector<std::string> args)
+    {
+        boost::iostreams::mapped_file_source m(filename);
+        Trie trie;
+        succinct::mapper::map(trie, m, succinct::mapper::map_flags::warmup);
+
+        if (args.empty()) {
+            args.push_back("a*");
+            args.push_back("*ing");
+            args.push_back("*th?n*");
+        }
+
+        for (size_t i = 0; i < args.size(); ++i) {
+            succinct::tries::dfa automaton(args[i], succinct::tries::dfa::glob_syntax);
+            std::vector<size_t> results;
+            size_t scan_matches = 0;
+
+            TIMEIT(benchmark_name + " - match '" + args[i] + "' - trie", 1) {
+                results.clear();
+                trie.match(automaton, std::back_inserter(results));
+            }
+
+            TIMEIT(benchmark_name + " - match '" + args[i] + "' - linear scan", 1) {
+                scan_matches = 0;
+                BOOST_FOREACH(std::string const& line, succinct::util::mmap_lines(strings_filename)) {
+                    scan_matches += automaton.matches(line);
+                }
+            }
+
+            std::cerr << "'" << args[i] << "': " << results.size() << " matches" << std::endl;
+            if (results.size() != scan_matches) {
+                std::cerr << "ERROR: linear scan found " << scan_matches << " matches" << std::endl;
+                return 1;
+            }
+        }
+        return 0;
+    }
+};
+
+// Trie with a two-tier labels pool: prepare takes a query log (one
+// string per line) and the fraction of hot labels, and moves the
+// labels most visited by the log to the hot tier before freezing
+template <typename Trie>
+class benchmark_trie_placed : public benchmark_trie_batch<Trie>
+{
+public:
+    virtual int prepare(std::string benchmark_name, std::string strings_filename, std::string output_filename, std::vector<std::string> args)
+    {
+        if (args.empty()) {
+            std::cerr << "Missing query log" << std::endl;
+            return 1;
+        }
+        double hot_fraction = args.size() > 1 ? std::atof(args[1].c_str()) : 0.01;
+
+        Trie trie;
+        TIMEIT(benchmark_name + " - construction", 1) {
+            Trie(succinct::util::mmap_lines(strings_filename)).swap(trie);
+        }
+        TIMEIT(benchmark_name + " - label placement", 1) {
+            trie.optimize_label_placement(succinct::util::mmap_lines(args[0]), hot_fraction);
+        }
+
+        succinct::mapper::size_tree_of(trie)->dump();
+        std::cerr << "hot labels " << trie.get_labels().hot_size() << " of " << trie.size() << std::endl;
+
+        succinct::mapper::freeze(trie, output_filename.c_str());
+        return 0;
+    }
+};
+
+// String to value map; prepare takes the values to attach, either
+// "position" (the line number, monotone) or "length" (the string
+// length, few distinct values)
+template <typename Trie, typename ValueCodec>
+class benchmark_trie_map : public benchmark
+{
+public:
+    typedef succinct::tries::trie_map<Trie, ValueCodec> map_type;
+
+    virtual int prepare(std::string benchmark_name, std::string strings_filename, std::string output_filename, std::vector<std::string> args)
+    {
+        bool by_length = !args.empty() && args[0] == "length";
+        std::vector<uint64_t> values;
+        BOOST_FOREACH(std::string const& line, succinct::util::mmap_lines(strings_filename)) {
+            values.push_back(by_length ? line.size() : values.size());
+        }
+
+        map_type map;
+        TIMEIT(benchmark_name + " - construction", 1) {
+            map_type(succinct::util::mmap_lines(strings_filename), values).swap(map);
+        }
+
+        succinct::mapper::size_tree_of(map)->dump();
+        std::cerr <<
+            "bits per string " << succinct::mapper::size_of(map) * 8.0 / map.size() << std::endl;
+
+        succinct::mapper::freeze(map, output_filename.c_str());
+        return 0;
+    }
+
+    virtual int measure(std::string benchmark_name, std::string filename, std::string sample_filename, std::vector<std::string> args)
+    {
+	succinct::util::mmap_lines sample_lines(sample_filename);
+	std::vector<std::string> strings_sample(sample_lines.begin(), sample_lines.end());
+
+        boost::iostreams::mapped_file_source m(filename);
+        map_type map;
+        succinct::mapper::map(map, m, succinct::mapper::map_flags::warmup);
+
+        volatile uint64_t foo;
+        uint64_t value = 0;
+        TIMEIT(benchmark_name + " - get", strings_sample.size()) {
+            for (size_t i = 0; i < strings_sample.size(); ++i) {
+                bool found = map.get(strings_sample[i], value);
+                foo = found ? value : 0;
+            }
+        }
+
+        std::vector<uint64_t> values;
+        TIMEIT(benchmark_name + " - get_batch", strings_sample.size()) {
+            map.get_batch(strings_sample, values, 0);
+        }
+        foo = values.size();
+        return 0;
+    }
+};
+
+// Builds the child directory of the nodes with at least the given
+// number of nodes below them (default 1024) before freezing
+template <typename Trie>
+class benchmark_trie_directory : public benchmark_trie_index<Trie>
+{
+public:
+    virtual int prepare(std::string benchmark_name, std::string strings_filename, std::string output_filename, std::vector<std::string> args)
+    {
+        size_t min_subtree_size = args.empty() ? 1024 : size_t(std::atol(args[0].c_str()));
+
+        Trie trie;
+        TIMEIT(benchmark_name + " - construction", 1) {
+            Trie(succinct::util::mmap_lines(strings_filename)).swap(trie);
+        }
+        TIMEIT(benchmark_name + " - child directory", 1) {
+            trie.build_child_directory(min_subtree_size);
+        }
+
+        succinct::mapper::size_tree_of(trie)->dump();
+        std::cerr <<
+            "bits per string " << succinct::mapper::size_of(trie) * 8.0 / trie.size() << std::endl;
+        std::cerr << "directory children " << trie.get_child_directory().size() << std::endl;
+
+        succinct::mapper::freeze(trie, output_filename.c_str());
+        return 0;
+    }
+};
+
+// Random queries on the mapped trie, directly and through a
+// hybrid_trie jump table built after mapping
+template <typename Trie>
+class benchmark_trie_hybrid : public benchmark_trie_index<Trie>
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string sample_filename, std::vector<std::string> args)
+    {
+        benchmark_trie_index<Trie>::measure(benchmark_name, filename, sample_filename, args);
+	succinct::util::mmap_lines sample_lines(sample_filename);
+	std::vector<std::string> strings_sample(sample_lines.begin(), sample_lines.end());
+
+        boost::iostreams::mapped_file_source m(filename);
+        Trie trie;
+        succinct::mapper::map(trie, m, succinct::mapper::map_flags::warmup);
+
+        for (size_t prefix_bytes = 1; prefix_bytes <= 2; ++prefix_bytes) {
+            std::ostringstream msg;
+            msg << benchmark_name << " - hybrid " << prefix_bytes << " bytes";
+            boost::shared_ptr<succinct::tries::hybrid_trie<Trie> > hybrid;
+            TIMEIT(msg.str() + " - table construction", 1) {
+                hybrid = boost::make_shared<succinct::tries::hybrid_trie<Trie> >(boost::cref(trie), prefix_bytes);
+            }
+
+            volatile size_t foo;
+            TIMEIT(msg.str() + " - random queries", strings_sample.size()) {
+                for (size_t i = 0; i < strings_sample.size(); ++i) {
+                    foo = hybrid->index(strings_sample[i]);
+                }
+            }
+        }
+        return 0;
+    }
+};
+
+// Draws n ranks in [0, universe) from a Zipf distribution of the given
+// exponent, rank 0 being the most frequent
+std::vector<size_t> zipf_sample(size_t universe, double exponent, size_t n)
+{
+    std::vector<double> cdf(universe);
+    double sum = 0;
+    for (size_t i = 0; i < universe; ++i) {
+        sum += 1 / std::pow(double(i + 1), exponent);
+        cdf[i] = sum;
+    }
+
+    std::vector<size_t> ret(n);
+    for (size_t i = 0; i < n; ++i) {
+        double r = sum * (double(rand()) * RAND_MAX + rand()) / (double(RAND_MAX) * RAND_MAX + RAND_MAX);
+        ret[i] = std::min(size_t(std::lower_bound(cdf.begin(), cdf.end(), r) - cdf.begin()), universe - 1);
+    }
+    return ret;
+}
+
+// Replays Zipfian queries drawn from the sample, directly on the trie
+// and through a cached_trie; the arguments are the Zipf exponent
+// (default 1) and the cache capacity (default 65536)
+template <typename Trie>
+class benchmark_trie_cached : public benchmark_trie_index<Trie>
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string sample_filename, std::vector<std::string> args)
+    {
+	succinct::util::mmap_lines sample_lines(sample_filename);
+	std::vector<std::string> strings_sample(sample_lines.begin(), sample_lines.end());
+        double exponent = args.size() > 0 ? std::atof(args[0].c_str()) : 1.0;
+        size_t capacity = args.size() > 1 ? std::atol(args[1].c_str()) : 65536;
+
+        boost::iostreams::mapped_file_source m(filename);
+        Trie trie;
+        succinct::mapper::map(trie, m, succinct::mapper::map_flags::warmup);
+
+        // the queries are shuffled so that ranks are not correlated with ids
+        std::random_shuffle(strings_sample.begin(), strings_sample.end());
+        std::vector<size_t> queries = zipf_sample(strings_sample.size(), exponent, 1000000);
+        std::vector<size_t> ids(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            ids[i] = trie.index(strings_sample[queries[i]]);
+        }
+
+        std::ostringstream msg;
+        msg << benchmark_name << " - zipf " << exponent;
+        volatile size_t foo;
+        TIMEIT(msg.str() + " - index", queries.size()) {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                foo = trie.index(strings_sample[queries[i]]);
+            }
+        }
+        TIMEIT(msg.str() + " - operator[]", ids.size()) {
+            for (size_t i = 0; i < ids.size(); ++i) {
+                foo = trie[ids[i]].size();
+            }
+        }
+
+        succinct::tries::cached_trie<Trie> cached(trie, capacity);
+        TIMEIT(msg.str() + " - cached index", queries.size()) {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                foo = cached.index(strings_sample[queries[i]]);
+            }
+        }
+        TIMEIT(msg.str() + " - cached operator[]", ids.size()) {
+            for (size_t i = 0; i < ids.size(); ++i) {
+                foo = cached[ids[i]].size();
+            }
+        }
+
+        typename succinct::tries::cached_trie<Trie>::cache_stats stats = cached.stats();
+        std::cerr << "capacity " << capacity
+                  << " index hit ratio " << double(stats.index_hits) / (stats.index_hits + stats.index_misses)
+                  << " operator[] hit ratio " << double(stats.lookup_hits) / (stats.lookup_hits + stats.lookup_misses)
+                  << std::endl;
+        return 0;
+    }
+};
+
+// Compares the trie with and without the xor filter in front of
+// index(), on query mixes with an increasing fraction of misses (the
+// sample strings with a byte appended); args override the miss
+// percentages
+template <typename Trie>
+class benchmark_trie_filtered : public benchmark_trie_index<succinct::tries::filtered_trie<Trie> >
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string sample_filename, std::vector<std::string> args)
+    {
+	succinct::util::mmap_lines sample_lines(sample_filename);
+	std::vector<std::string> strings_sample(sample_lines.begin(), sample_lines.end());
+
+        std::vector<size_t> miss_percentages;
+        for (size_t i = 0; i < args.size(); ++i) {
+            miss_percentages.push_back(std::atol(args[i].c_str()));
+        }
+        if (miss_percentages.empty()) {
+            size_t defaults[] = {0, 25, 50, 75, 90, 99};
+            miss_percentages.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+        }
+
+        boost::iostreams::mapped_file_source m(filename);
+        succinct::tries::filtered_trie<Trie> filtered;
+        succinct::mapper::map(filtered, m, succinct::mapper::map_flags::warmup);
+        Trie const& trie = filtered.get_trie();
+
+        srand(42);
+        volatile size_t foo;
+        for (size_t p = 0; p < miss_percentages.size(); ++p) {
+            std::vector<std::string> queries(strings_sample);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                if (size_t(rand() % 100) < miss_percentages[p]) {
+                    queries[i] += '\x01';
+                }
+            }
+
+            std::ostringstream msg;
+            msg << benchmark_name << " - " << miss_percentages[p] << "% misses";
+            TIMEIT(msg.str() + " - unfiltered", queries.size()) {
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    foo = trie.index(queries[i]);
+                }
+            }
+            TIMEIT(msg.str() + " - filtered", queries.size()) {
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    foo = filtered.index(queries[i]);
+                }
+            }
+        }
+        return 0;
+    }
+};
+
+struct count_visitor
+{
+    count_visitor()
+        : m_count(0)
+    {}
+
+    void operator()(size_t, size_t, size_t)
+    {
+        m_count += 1;
+    }
+
+    size_t m_count;
+};
+
+// Scans a text file against the keys of the trie, reporting the
+// throughput in MB/s; measure takes the text file in place of the sample
+template <typename Trie>
+class benchmark_trie_scan : public benchmark_trie_index<Trie>
+{
+public:
+    virtual int measure(std::string benchmark_name, std::string filename, std::string text_filename, std::vector<std::string> args)
+    {
+        boost::iostreams::mapped_file_source m(filename);
+        Trie trie;
+        succinct::mapper::map(trie, m, succinct::mapper::map_flags::warmup);
+
+        boost::iostreams::mapped_file_source text_file(text_filename);
+        const uint8_t* text = reinterpret_cast<const uint8_t*>(text_file.data());
+        size_t text_size = text_file.size();
+
+        succinct::tries::dictionary_scanner<Trie> scanner(trie);
+
+        count_visitor all_visitor;
+        report_throughput(benchmark_name + " - find_all", text_size,
+                          scan_find_all(scanner, text, text_size, all_visitor));
+        std::cerr << all_visitor.m_count << " occurrences" << std::endl;
+
+        count_visitor segment_visitor;
+        report_throughput(benchmark_name + " - segment", text_size,
+                          scan_segment(scanner, text, text_size, segment_visitor));
+        std::cerr << segment_visitor.m_count << " segments" << std::endl;
+        return 0;
+    }
+
+private:
+    typedef boost::posix_time::ptime ptime;
+
+    static double scan_find_all(succinct::tries::dictionary_scanner<Trie> const& scanner,
+                                const uint8_t* text, size_t text_size, count_visitor& visitor)
+    {
+        ptime tick = boost::posix_time::microsec_clock::universal_time();
+        scanner.find_all(text, text_size, visitor);
+        return double((boost::posix_time::microsec_clock::universal_time() - tick).total_microseconds());
+    }
+
+    static double scan_segment(succinct::tries::dictionary_scanner<Trie> const& scanner,
+                               const uint8_t* text, size_t text_size, count_visitor& visitor)
+    {
+        ptime tick = boost::posix_time::microsec_clock::universal_time();
+        scanner.segment(text, text_size, visitor);
+        return double((boost::posix_time::microsec_clock::universal_time() - tick).total_microseconds());
+    }
+
+    static void report_throughput(std::string msg, size_t bytes, double elapsed_usec)
+    {
+        std::cerr << msg << " elapsed=" << elapsed_usec / 1000 << "ms"
+                  << " throughput=" << bytes / elapsed_usec << "MB/s" << std::endl;
+    }
+};
 
 typedef std::map<std::string, boost::shared_ptr<benchmark> > benchmarks_type;
 
@@ -190,12 +665,49 @@ int main(int argc, char** argv)
     benchmarks["hollow_elias"] = make_shared<benchmark_trie_index<succinct::tries::hollow_trie<succinct::elias_fano_list> > >();
     benchmarks["hollow_vector"] = make_shared<benchmark_trie_index<succinct::tries::hollow_trie<succinct::mapper::mappable_vector<uint16_t> > > >();
     benchmarks["centroid_hollow"] = make_shared<benchmark_trie_index<succinct::tries::centroid_hollow_trie> >();
+    benchmarks["centroid_hollow_remapped"] = make_shared<benchmark_trie_index<succinct::tries::remapped_trie<succinct::tries::centroid_hollow_trie, true> > >();
+    benchmarks["centroid_hollow_dir"] = make_shared<benchmark_trie_directory<succinct::tries::basic_centroid_hollow_trie<true> > >();
+
+    benchmarks["centroid"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["centroid_repair"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool > > >();
+
+    benchmarks["lex"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
+    benchmarks["lex_repair"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> > >();
+    benchmarks["centroid_first_chars"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, true> > >();
+    benchmarks["lex_first_chars"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true, true> > >();
+    benchmarks["centroid_fsst"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::fsst_string_pool > > >();
+    benchmarks["lex_fsst"] = make_shared<benchmark_trie_batch<succinct::tries::path_decomposed_trie<succinct::tries::fsst_string_pool, true> > >();
+
+    benchmarks["centroid_placed"] = make_shared<benchmark_trie_placed<succinct::tries::path_decomposed_trie<succinct::tries::two_tier_string_pool<succinct::tries::vbyte_string_pool> > > >();
+    benchmarks["lex_placed"] = make_shared<benchmark_trie_placed<succinct::tries::path_decomposed_trie<succinct::tries::two_tier_string_pool<succinct::tries::vbyte_string_pool>, true> > >();
+
+    benchmarks["centroid_dir"] = make_shared<benchmark_trie_directory<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, false, uint8_t, true> > >();
+    benchmarks["lex_dir"] = make_shared<benchmark_trie_directory<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true, false, uint8_t, true> > >();
+
+    benchmarks["centroid_remapped"] = make_shared<benchmark_trie_2way<succinct::tries::remapped_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> > > >();
+    benchmarks["lex_remapped"] = make_shared<benchmark_trie_2way<succinct::tries::remapped_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > > >();
+
+    benchmarks["centroid_map"] = make_shared<benchmark_trie_map<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool>, succinct::tries::packed_vector> >();
+    benchmarks["centroid_map_dict"] = make_shared<benchmark_trie_map<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool>, succinct::tries::dictionary_values> >();
+    benchmarks["lex_map_ef"] = make_shared<benchmark_trie_map<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true>, succinct::tries::elias_fano_values> >();
+
+    benchmarks["centroid_packed"] = make_shared<benchmark_trie_2way<succinct::tries::packed_path_decomposed_trie<> > >();
+    benchmarks["lex_packed"] = make_shared<benchmark_trie_2way<succinct::tries::packed_path_decomposed_trie<true> > >();
+
+    benchmarks["centroid_hybrid"] = make_shared<benchmark_trie_hybrid<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["lex_hybrid"] = make_shared<benchmark_trie_hybrid<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
+
+    benchmarks["centroid_cached"] = make_shared<benchmark_trie_cached<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["lex_cached"] = make_shared<benchmark_trie_cached<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
+
+    benchmarks["centroid_filtered"] = make_shared<benchmark_trie_filtered<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["lex_filtered"] = make_shared<benchmark_trie_filtered<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
 
-    benchmarks["centroid"] = make_shared<benchmark_trie_2way<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
-    benchmarks["centroid_repair"] = make_shared<benchmark_trie_2way<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool > > >();
+    benchmarks["centroid_match"] = make_shared<benchmark_trie_match<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["lex_match"] = make_shared<benchmark_trie_match<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
 
-    benchmarks["lex"] = make_shared<benchmark_trie_2way<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
-    benchmarks["lex_repair"] = make_shared<benchmark_trie_2way<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> > >();
+    benchmarks["centroid_scan"] = make_shared<benchmark_trie_scan<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool > > >();
+    benchmarks["lex_scan"] = make_shared<benchmark_trie_scan<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> > >();
 
     if (argc == 1) {
         print_benchmarks(benchmarks);
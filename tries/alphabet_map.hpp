@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "succinct/mappable_vector.hpp"
+
+#include "bit_strings.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Order-preserving map from the bytes that occur in a set of keys
+    // to the dense codes 1..size(); code 0 is the terminator. Keys
+    // over a small alphabet (DNA, digits, hex) can then be encoded
+    // either with a byte per code, which keeps them valid strings for
+    // the byte tries, or packed in bits() bits per code for the binary
+    // tries. Both encodings preserve the order and the prefix-freeness
+    // of the keys
+    struct alphabet_map
+    {
+        alphabet_map()
+            : m_bits(8)
+        {}
+
+	template <typename Range, typename Adaptor>
+        alphabet_map(Range const& strings, Adaptor adaptor)
+        {
+            std::vector<bool> used(256);
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            for (iterator_t iter = boost::begin(strings); iter != boost::end(strings); ++iter) {
+                char_range s = adaptor(*iter);
+                for (const uint8_t* c = s.first; c != s.second; ++c) {
+                    used[*c] = true;
+                }
+            }
+
+            std::vector<uint8_t> codes(256);
+            std::vector<uint8_t> symbols(1, 0);
+            for (size_t c = 1; c < 256; ++c) {
+                if (used[c]) {
+                    codes[c] = uint8_t(symbols.size());
+                    symbols.push_back(uint8_t(c));
+                }
+            }
+
+            m_bits = 1;
+            while ((size_t(1) << m_bits) < symbols.size()) ++m_bits;
+
+            mapper::mappable_vector<uint8_t>(codes).swap(m_codes);
+            mapper::mappable_vector<uint8_t>(symbols).swap(m_symbols);
+        }
+
+        // Number of symbols, excluding the terminator
+        size_t size() const
+        {
+            return m_symbols.size() - 1;
+        }
+
+        // Bits per code in the packed encoding
+        size_t bits() const
+        {
+            return m_bits;
+        }
+
+        // Code of c, 0 if c is not in the alphabet
+        uint8_t code(uint8_t c) const
+        {
+            return m_codes[c];
+        }
+
+        uint8_t symbol(uint8_t code) const
+        {
+            return m_symbols[code];
+        }
+
+        // Writes to out the codes of the len bytes at s followed by the
+        // terminator, and returns the number of bytes written (at most
+        // len + 1), or size_t(-1) if a byte is not in the alphabet
+        size_t encode(const uint8_t* s, size_t len, uint8_t* out, bool packed) const
+        {
+            if (!packed) {
+                for (size_t i = 0; i < len; ++i) {
+                    uint8_t c = m_codes[s[i]];
+                    if (!c) return size_t(-1);
+                    out[i] = c;
+                }
+                out[len] = 0;
+                return len + 1;
+            }
+
+            // most significant bits first, so that the byte order is
+            // the order of the codes
+            uint64_t acc = 0;
+            size_t acc_bits = 0;
+            size_t n = 0;
+            for (size_t i = 0; i <= len; ++i) {
+                uint8_t c = 0;
+                if (i < len) {
+                    c = m_codes[s[i]];
+                    if (!c) return size_t(-1);
+                }
+                acc = (acc << m_bits) | c;
+                acc_bits += m_bits;
+                while (acc_bits >= 8) {
+                    acc_bits -= 8;
+                    out[n++] = uint8_t(acc >> acc_bits);
+                }
+                acc &= (uint64_t(1) << acc_bits) - 1;
+            }
+            if (acc_bits) {
+                out[n++] = uint8_t(acc << (8 - acc_bits));
+            }
+            return n;
+        }
+
+        // Decodes a string of byte codes, without terminator
+        std::string decode(std::string const& codes) const
+        {
+            std::string ret(codes);
+            for (size_t i = 0; i < ret.size(); ++i) {
+                ret[i] = char(m_symbols[uint8_t(ret[i])]);
+            }
+            return ret;
+        }
+
+        void swap(alphabet_map& other)
+        {
+            std::swap(m_bits, other.m_bits);
+            m_codes.swap(other.m_codes);
+            m_symbols.swap(other.m_symbols);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_bits, "m_bits")
+                (m_codes, "m_codes")
+                (m_symbols, "m_symbols")
+                ;
+        }
+
+    private:
+        uint64_t m_bits;
+        mapper::mappable_vector<uint8_t> m_codes;
+        mapper::mappable_vector<uint8_t> m_symbols;
+    };
+
+}
+}
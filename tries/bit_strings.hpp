@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <vector>
 
 #include "succinct/util.hpp"
 
@@ -10,6 +11,19 @@ namespace tries {
     using util::char_range;
     using util::stl_string_adaptor;
 
+    // Keys over a wider alphabet (for example sequences of token ids)
+    // are arrays of SymbolType ending with a 0 symbol, which cannot
+    // appear elsewhere in the key, like the terminator of C strings
+    template <typename SymbolType>
+    struct stl_vector_adaptor {
+        typedef std::pair<const SymbolType*, const SymbolType*> range_type;
+
+        range_type operator()(std::vector<SymbolType> const& v) const {
+            assert(!v.empty() && !v.back());
+            return range_type(&v[0], &v[0] + v.size());
+        }
+    };
+
     template <typename Bytes>
     inline uint8_t get_byte(Bytes const& buf, size_t buf_bit_len, size_t offset)
     {
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/range.hpp>
+#include <boost/static_assert.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "bit_strings.hpp"
+#include "string_hash.hpp"
+
+namespace succinct {
+namespace tries {
+
+    namespace detail {
+
+        // Minimal atomics for the seqlocks of cached_trie, as the code
+        // base does not assume C++11
+#if defined(_MSC_VER)
+        typedef long atomic_word;
+
+        inline void memory_fence()
+        {
+            _ReadWriteBarrier();
+            _mm_mfence();
+        }
+
+        inline bool atomic_cas(volatile atomic_word* p, atomic_word expected, atomic_word desired)
+        {
+            return _InterlockedCompareExchange(p, desired, expected) == expected;
+        }
+
+        inline void atomic_increment(volatile int64_t* p)
+        {
+            _InterlockedIncrement64(p);
+        }
+#else
+        typedef long atomic_word;
+
+        inline void memory_fence()
+        {
+            __sync_synchronize();
+        }
+
+        inline bool atomic_cas(volatile atomic_word* p, atomic_word expected, atomic_word desired)
+        {
+            return __sync_bool_compare_and_swap(p, expected, desired);
+        }
+
+        inline void atomic_increment(volatile int64_t* p)
+        {
+            __sync_fetch_and_add(p, 1);
+        }
+#endif
+    }
+
+    // Bounded cache of the results of index() and operator[] in front
+    // of any trie, for skewed query distributions. Each direction has
+    // an open-addressing table of 64-byte slots, grouped in buckets of
+    // 4 selected by the hash of the key (or of the id); a slot holds
+    // the string inline, so keys longer than max_key_len are never
+    // cached. Eviction is CLOCK within the bucket.
+    //
+    // The wrapper is thread-safe: reads are lock-free, each slot is
+    // protected by a sequence counter which the writer makes odd while
+    // it updates the slot, and readers retry elsewhere (that is, miss)
+    // if the counter is odd or changes during the read. A writer that
+    // finds a slot busy gives up the insertion. The hit and miss
+    // counters are sharded in cache lines, so that concurrent readers
+    // do not all update the same line. The trie must outlive the
+    // wrapper
+    template <typename Trie>
+    struct cached_trie : boost::noncopyable
+    {
+        typedef Trie trie_type;
+
+        static const size_t bucket_size = 4;
+        static const size_t slot_size = 64;
+
+        struct cache_stats
+        {
+            int64_t index_hits;
+            int64_t index_misses;
+            int64_t lookup_hits;
+            int64_t lookup_misses;
+        };
+
+        // capacity is the number of entries of each table, rounded up
+        // to a power of two
+        cached_trie(Trie const& trie, size_t capacity)
+            : m_trie(trie)
+        {
+            size_t n_buckets = 1;
+            while (n_buckets * bucket_size < capacity) n_buckets *= 2;
+            m_bucket_mask = n_buckets - 1;
+            m_index_table.init(n_buckets);
+            m_lookup_table.init(n_buckets);
+            m_stats.init();
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // the terminator is not stored
+
+            if (len > max_key_len) {
+                m_stats.increment(index_miss);
+                return m_trie.index(val, adaptor);
+            }
+
+            size_t bucket = hash_bytes(s.first, len) & m_bucket_mask;
+            uint64_t ret;
+            if (m_index_table.find_by_key(bucket, s.first, len, ret)) {
+                m_stats.increment(index_hit);
+                return size_t(ret);
+            }
+
+            m_stats.increment(index_miss);
+            ret = m_trie.index(val, adaptor);
+            m_index_table.insert(bucket, s.first, len, ret);
+            return size_t(ret);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        std::string operator[](size_t idx) const
+        {
+            size_t bucket = hash_int(idx) & m_bucket_mask;
+            std::string ret;
+            if (m_lookup_table.find_by_value(bucket, idx, ret)) {
+                m_stats.increment(lookup_hit);
+                return ret;
+            }
+
+            m_stats.increment(lookup_miss);
+            ret = m_trie[idx];
+            if (ret.size() <= max_key_len) {
+                m_lookup_table.insert(bucket, reinterpret_cast<const uint8_t*>(ret.data()), ret.size(), idx);
+            }
+            return ret;
+        }
+
+        size_t size() const
+        {
+            return m_trie.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+        // The counters are updated atomically, but read independently
+        cache_stats stats() const
+        {
+            cache_stats ret;
+            ret.index_hits = m_stats.sum(index_hit);
+            ret.index_misses = m_stats.sum(index_miss);
+            ret.lookup_hits = m_stats.sum(lookup_hit);
+            ret.lookup_misses = m_stats.sum(lookup_miss);
+            return ret;
+        }
+
+        void reset_stats()
+        {
+            m_stats.reset();
+        }
+
+    private:
+
+        // the value comes first, so that no padding is needed whatever
+        // the size of atomic_word (a long, 4 bytes on Windows)
+        struct slot
+        {
+            uint64_t value;
+            volatile detail::atomic_word seq; // odd while the slot is written
+            uint8_t referenced;
+            uint8_t key_len;
+            uint8_t key[slot_size - sizeof(uint64_t) - sizeof(detail::atomic_word) - 2];
+        };
+        BOOST_STATIC_ASSERT(sizeof(slot) == slot_size);
+
+        static const size_t max_key_len = sizeof(((slot*)0)->key);
+        static const uint8_t empty_slot = 0xff;
+
+        struct table
+        {
+            void init(size_t n_buckets)
+            {
+                // align the slots to the cache lines
+                m_buffer.assign(n_buckets * bucket_size * sizeof(slot) + slot_size, 0);
+                size_t misalignment = size_t(&m_buffer[0]) % slot_size;
+                m_slots = reinterpret_cast<slot*>(&m_buffer[0] + (misalignment ? slot_size - misalignment : 0));
+                for (size_t i = 0; i < n_buckets * bucket_size; ++i) {
+                    m_slots[i].key_len = empty_slot;
+                }
+                m_clock_hands.assign(n_buckets, 0);
+            }
+
+            bool find_by_key(size_t bucket, const uint8_t* key, size_t len, uint64_t& value)
+            {
+                for (size_t i = 0; i < bucket_size; ++i) {
+                    slot& sl = m_slots[bucket * bucket_size + i];
+                    detail::atomic_word seq = sl.seq;
+                    detail::memory_fence();
+                    if ((seq & 1) || sl.key_len != len || std::memcmp(sl.key, key, len)) continue;
+                    uint64_t v = sl.value;
+                    detail::memory_fence();
+                    if (sl.seq != seq) continue;
+                    // racy, only affects eviction; written only when
+                    // clear, so hot slots are not written on each hit
+                    if (!sl.referenced) sl.referenced = 1;
+                    value = v;
+                    return true;
+                }
+                return false;
+            }
+
+            bool find_by_value(size_t bucket, uint64_t value, std::string& key)
+            {
+                for (size_t i = 0; i < bucket_size; ++i) {
+                    slot& sl = m_slots[bucket * bucket_size + i];
+                    detail::atomic_word seq = sl.seq;
+                    detail::memory_fence();
+                    if ((seq & 1) || sl.key_len == empty_slot || sl.value != value) continue;
+                    size_t len = std::min(size_t(sl.key_len), size_t(max_key_len));
+                    key.assign(reinterpret_cast<const char*>(sl.key), len);
+                    detail::memory_fence();
+                    if (sl.seq != seq) continue;
+                    if (!sl.referenced) sl.referenced = 1;
+                    return true;
+                }
+                return false;
+            }
+
+            void insert(size_t bucket, const uint8_t* key, size_t len, uint64_t value)
+            {
+                assert(len <= max_key_len);
+                // CLOCK: the first unreferenced slot from the hand,
+                // clearing the reference bits on the way
+                size_t hand = m_clock_hands[bucket];
+                for (size_t step = 0; step < 2 * bucket_size; ++step) {
+                    size_t i = (hand + step) % bucket_size;
+                    slot& sl = m_slots[bucket * bucket_size + i];
+                    if (sl.referenced && sl.key_len != empty_slot) {
+                        sl.referenced = 0;
+                        continue;
+                    }
+
+                    m_clock_hands[bucket] = uint8_t((i + 1) % bucket_size);
+                    detail::atomic_word seq = sl.seq;
+                    if ((seq & 1) || !detail::atomic_cas(&sl.seq, seq, seq + 1)) {
+                        return; // another writer is here
+                    }
+                    sl.key_len = uint8_t(len);
+                    std::memcpy(sl.key, key, len);
+                    sl.value = value;
+                    sl.referenced = 0;
+                    detail::memory_fence();
+                    sl.seq = seq + 2;
+                    return;
+                }
+            }
+
+            std::vector<uint8_t> m_buffer;
+            slot* m_slots;
+            std::vector<uint8_t> m_clock_hands;
+        };
+
+        enum counter_type {
+            index_hit,
+            index_miss,
+            lookup_hit,
+            lookup_miss,
+            n_counters
+        };
+
+        static const size_t stats_shards = 16;
+
+        struct stats_counters
+        {
+            struct shard
+            {
+                volatile int64_t counters[n_counters];
+                uint8_t padding[slot_size - n_counters * sizeof(int64_t)];
+            };
+            BOOST_STATIC_ASSERT(sizeof(shard) == slot_size);
+
+            void init()
+            {
+                // align the shards to the cache lines
+                m_buffer.assign((stats_shards + 1) * sizeof(shard), 0);
+                size_t misalignment = size_t(&m_buffer[0]) % slot_size;
+                m_shards = reinterpret_cast<shard*>(&m_buffer[0] + (misalignment ? slot_size - misalignment : 0));
+                reset();
+            }
+
+            void increment(counter_type counter)
+            {
+                detail::atomic_increment(&m_shards[thread_shard()].counters[counter]);
+            }
+
+            int64_t sum(counter_type counter) const
+            {
+                int64_t ret = 0;
+                for (size_t i = 0; i < stats_shards; ++i) {
+                    ret += m_shards[i].counters[counter];
+                }
+                return ret;
+            }
+
+            void reset()
+            {
+                for (size_t i = 0; i < stats_shards; ++i) {
+                    for (size_t c = 0; c < n_counters; ++c) {
+                        m_shards[i].counters[c] = 0;
+                    }
+                }
+            }
+
+            // The address of a local variable is in the stack of the
+            // calling thread, so different threads most likely get
+            // different shards, without thread-local storage
+            static size_t thread_shard()
+            {
+                volatile char local = 0;
+                return size_t(hash_int(uint64_t(size_t(&local)) >> 12) % stats_shards);
+            }
+
+            std::vector<uint8_t> m_buffer;
+            shard* m_shards;
+        };
+
+        Trie const& m_trie;
+        size_t m_bucket_mask;
+        mutable table m_index_table;
+        mutable table m_lookup_table;
+        mutable stats_counters m_stats;
+    };
+
+}
+}
@@ -2,46 +2,101 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/static_assert.hpp>
 
 #include "succinct/bp_vector.hpp"
 #include "succinct/forward_enumerator.hpp"
 #include "succinct/gamma_bit_vector.hpp"
 
 #include "patricia_builder.hpp"
+#include "child_directory.hpp"
+#include "optional_field.hpp"
 
 namespace succinct {
 namespace tries {
 
-    struct centroid_hollow_trie
+    // When ChildDirectory is true, build_child_directory() can add a
+    // child_directory that index() uses to descend the large subtrees,
+    // and the directory is mapped with the trie. Otherwise the format
+    // is the same as without the directory: centroid_hollow_trie is
+    // the trie without it
+    template <bool ChildDirectory>
+    struct basic_centroid_hollow_trie
     {
         typedef gamma_bit_vector skips_type;
 
-        centroid_hollow_trie()
+        basic_centroid_hollow_trie()
 	{}
 
 	template <typename Range, typename Adaptor>
-	centroid_hollow_trie(Range const& strings, Adaptor adaptor = stl_string_adaptor()) 
+	basic_centroid_hollow_trie(Range const& strings, Adaptor adaptor = stl_string_adaptor()) 
 	{
 	    build(strings, adaptor);
 	}
 	
 	template <typename Range>
-	centroid_hollow_trie(Range const& strings) 
+	basic_centroid_hollow_trie(Range const& strings) 
 	{
 	    build(strings, stl_string_adaptor());
 	}
 
+        // Builds the trie following at each node the child with the
+        // largest total weight (ties broken by size), with one weight
+        // for each string in the same order, as in path_decomposed_trie
+	template <typename Range, typename Adaptor, typename Weights>
+	basic_centroid_hollow_trie(Range const& strings, Adaptor adaptor, Weights const& weights)
+	{
+            std::vector<double> w(boost::begin(weights), boost::end(weights));
+            if (w.size() != size_t(std::distance(boost::begin(strings), boost::end(strings)))) {
+                throw std::invalid_argument("The number of weights does not match the number of strings");
+            }
+	    build(strings, adaptor, &w);
+	}
+
 	template <typename T, typename Adaptor>
 	size_t index(T const& val, Adaptor adaptor) const
+	{
+            size_t depth;
+            return index(val, adaptor, depth);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        // Number of nodes visited by the lookup of val, for example to
+        // measure the effect of a weighted decomposition
+	template <typename T, typename Adaptor>
+	size_t lookup_depth(T const& val, Adaptor adaptor) const
+	{
+            size_t depth;
+            index(val, adaptor, depth);
+            return depth;
+        }
+
+	template <typename T>
+	size_t lookup_depth(T const& val) const
+	{
+	    return lookup_depth(val, stl_string_adaptor());
+	}
+
+        // Same as index(), also returning in depth the number of nodes
+        // visited
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor, size_t& depth) const
 	{
 	    char_range s = adaptor(val);
 	    size_t bit_len = boost::size(s) * 8;
+            depth = 1;
 
 	    size_t cur_pos = 0;
 	    size_t cur_node_pos = 1;
             size_t right_ancestors = 0;
 
             size_t first_child_rank = 0;
+            size_t node_dir = ChildDirectory ? m_child_directory.root() : 0;
 
             while (true) {
                 size_t node_end = m_bp.successor0(cur_node_pos); 
@@ -72,10 +127,16 @@ namespace tries {
                         }
                         assert(child < node_deg);
                         size_t child_open = node_end - child - 1;
-                        cur_node_pos = m_bp.find_close(child_open) + 1;
+                        if (ChildDirectory && node_dir) {
+                            size_t offset = child_open - cur_node_pos;
+                            cur_node_pos = m_child_directory.child_pos(node_dir, offset);
+                            node_dir = m_child_directory.child_dir(node_dir, offset);
+                        } else {
+                            cur_node_pos = m_bp.find_close(child_open) + 1;
+                        }
                         assert((cur_node_pos - child_open) % 2 == 0);
                         first_child_rank += (node_deg - child - 1) + (cur_node_pos - child_open) / 2;
-                        
+                        depth += 1;
                         break;
                     }
                     taken_directions[dir] += 1;
@@ -96,22 +157,17 @@ namespace tries {
 
             assert(false);
         }
-
-	template <typename T>
-	size_t index(T const& val) const
-	{
-	    return index(val, stl_string_adaptor());
-	}
         
         size_t size() const
         {
             return m_bp.size() / 2;
         }
 
-	void swap(centroid_hollow_trie& other)
+	void swap(basic_centroid_hollow_trie& other)
         {
 	    m_bp.swap(other.m_bp);
 	    m_skips.swap(other.m_skips);
+	    m_child_directory.swap(other.m_child_directory);
 	}
 
         template <typename Visitor>
@@ -120,6 +176,22 @@ namespace tries {
                 (m_bp, "m_bp")
                 (m_skips, "m_skips")
 		;
+            optional_field<ChildDirectory>::map(visit, m_child_directory, "m_child_directory");
+        }
+
+        // Builds the directory of the children positions of the nodes
+        // with at least min_subtree_size nodes below them, which
+        // index() uses instead of find_close (see child_directory).
+        // Only when ChildDirectory is true
+        void build_child_directory(size_t min_subtree_size)
+        {
+            BOOST_STATIC_ASSERT(ChildDirectory);
+            child_directory(m_bp, min_subtree_size).swap(m_child_directory);
+        }
+
+        child_directory const& get_child_directory() const
+        {
+            return m_child_directory;
         }
 
         bp_vector const& get_bp() const
@@ -136,14 +208,21 @@ namespace tries {
 
 	struct centroid_builder_visitor
 	{
-	    centroid_builder_visitor()
+	    centroid_builder_visitor(std::vector<double> const* weights = 0)
+                : m_weights(weights)
+                , m_n_leaves(0)
 	    {}
 
 	    struct subtree {
+                subtree()
+                    : m_weight(0)
+                {}
+
 		std::vector<uint64_t> m_centroid_path_skips;
 
 		bit_vector_builder m_bp;
 		std::vector<uint64_t> m_skips;
+                double m_weight; // total weight of the keys, if weighted
 
 		size_t size() const
 		{
@@ -166,18 +245,28 @@ namespace tries {
 
 	    typedef boost::shared_ptr<subtree> representation_type;
 
-	    representation_type leaf(const uint8_t* buf, size_t offset, size_t skip) const
+	    representation_type leaf(const uint8_t* buf, size_t offset, size_t skip)
 	    {
 		representation_type ret = boost::make_shared<subtree>();
+                // leaves are created in the order of the strings
+                if (m_weights) {
+                    ret->m_weight = (*m_weights)[m_n_leaves++];
+                }
 		return ret;
 	    }
 
 	    representation_type node(representation_type& left, representation_type& right, const uint8_t* buf, size_t offset, size_t skip) const
 	    {
 		representation_type ret = boost::make_shared<subtree>();
+                ret->m_weight = left->m_weight + right->m_weight;
 		
 		bool centroid_direction;
-		if (left->size() >= right->size()) {
+                // index() relies on the last step of each centroid path
+                // going left, so a right leaf is never the heavy child
+                bool left_heavier = (m_weights && left->m_weight != right->m_weight && right->size() > 1)
+                    ? left->m_weight > right->m_weight
+                    : left->size() >= right->size();
+		if (left_heavier) {
 		    std::swap(ret->m_centroid_path_skips, left->m_centroid_path_skips);
 		    centroid_direction = 0;
 		} else {
@@ -216,13 +305,15 @@ namespace tries {
 
 	private:
 	    representation_type m_root_node;
+            std::vector<double> const* m_weights;
+            size_t m_n_leaves;
 	};
 
 
 	template <typename Range, typename Adaptor>
-	void build(Range const& strings, Adaptor adaptor) 
+	void build(Range const& strings, Adaptor adaptor, std::vector<double> const* weights = 0)
 	{
-	    centroid_builder_visitor visitor;
+	    centroid_builder_visitor visitor(weights);
 	    succinct::tries::patricia_builder<centroid_builder_visitor> builder;
 	    builder.build(visitor, strings, adaptor);
 	    typename centroid_builder_visitor::representation_type root = visitor.get_root();
@@ -233,7 +324,10 @@ namespace tries {
 
 	bp_vector m_bp;
 	skips_type m_skips;
+        child_directory m_child_directory; // empty unless ChildDirectory and built
     };
 
+    typedef basic_centroid_hollow_trie<false> centroid_hollow_trie;
+
 }
 }
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "succinct/bp_vector.hpp"
+#include "succinct/mappable_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Side directory of a DFUDS tree that stores, for the nodes with
+    // a large subtree, the positions of their children, so that the
+    // descent through them reads an array entry instead of doing a
+    // find_close, which on large subtrees walks the range min-max tree
+    // and misses the cache.
+    //
+    // The nodes with a large subtree form a connected top of the tree,
+    // so the entry of each child also holds the directory of the child
+    // (if any): a lookup keeps the directory of the current node, 0
+    // when there is none (then it goes on with find_close), starting
+    // from root(). The entries of a node are indexed by the offset of
+    // the child opening parenthesis from the node position
+    struct child_directory
+    {
+        child_directory()
+        {}
+
+        // Directory of the nodes of bp (with the fake root at position
+        // 0, and the root at position 1) with at least min_subtree_size
+        // nodes in their subtree
+        child_directory(bp_vector const& bp, size_t min_subtree_size)
+        {
+            std::vector<uint64_t> entries;
+            if (bp.size() / 2 < std::max(min_subtree_size, size_t(1))) return;
+
+            std::vector<std::pair<size_t, size_t> > stack; // (node_pos, dir)
+            stack.push_back(std::make_pair(size_t(1), allocate(bp, 1, entries)));
+            while (!stack.empty()) {
+                size_t node_pos = stack.back().first;
+                size_t dir = stack.back().second;
+                stack.pop_back();
+
+                size_t deg = bp.successor0(node_pos) - node_pos;
+                for (size_t i = 0; i < deg; ++i) {
+                    size_t child_open = node_pos + i;
+                    size_t child_close = bp.find_close(child_open);
+                    size_t child_pos = child_close + 1;
+                    size_t child_dir = 0;
+                    if ((child_close - child_open + 1) / 2 >= min_subtree_size) {
+                        child_dir = allocate(bp, child_pos, entries);
+                        stack.push_back(std::make_pair(child_pos, child_dir));
+                    }
+                    entries[2 * (dir - 1 + i)] = child_pos;
+                    entries[2 * (dir - 1 + i) + 1] = child_dir;
+                }
+            }
+
+            mapper::mappable_vector<uint64_t>(entries).swap(m_entries);
+        }
+
+        // Directory of the root, 0 if the directory is empty
+        size_t root() const
+        {
+            return m_entries.size() ? 1 : 0;
+        }
+
+        // Position of the child whose opening parenthesis is at offset
+        // i from the node with directory dir
+        size_t child_pos(size_t dir, size_t i) const
+        {
+            assert(dir);
+            return m_entries[2 * (dir - 1 + i)];
+        }
+
+        // Directory of the same child, 0 if it has none
+        size_t child_dir(size_t dir, size_t i) const
+        {
+            assert(dir);
+            return m_entries[2 * (dir - 1 + i) + 1];
+        }
+
+        // Number of children in the directory
+        size_t size() const
+        {
+            return m_entries.size() / 2;
+        }
+
+        void swap(child_directory& other)
+        {
+            m_entries.swap(other.m_entries);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_entries, "m_entries")
+                ;
+        }
+
+    private:
+
+        // reserves the entries of the children of the node and returns
+        // its directory
+        static size_t allocate(bp_vector const& bp, size_t node_pos, std::vector<uint64_t>& entries)
+        {
+            size_t dir = entries.size() / 2 + 1;
+            size_t deg = bp.successor0(node_pos) - node_pos;
+            entries.resize(entries.size() + 2 * deg);
+            return dir;
+        }
+
+        // (child position, child directory) pairs, so that both are in
+        // the same cache line
+        mapper::mappable_vector<uint64_t> m_entries;
+    };
+
+}
+}
@@ -11,9 +11,13 @@
 namespace succinct {
 namespace tries {
 
-    template <typename TreeBuilder>
+    // SymbolType is the alphabet of the keys, given by the adaptor as
+    // ranges of SymbolType; the children are labeled by a symbol
+    template <typename TreeBuilder, typename SymbolType = uint8_t>
     struct compacted_trie_builder
     {
+        typedef std::pair<const SymbolType*, const SymbolType*> symbol_range;
+
 	template <typename Range, typename Adaptor>
 	void build(TreeBuilder& visitor, Range const& strings, Adaptor adaptor)
 	{
@@ -23,16 +27,16 @@ namespace tries {
 	    iterator_t iter = boost::begin(strings);
 	    
 	    std::vector<node> stack;
-	    char_range first_string = adaptor(*iter);
-	    std::vector<uint8_t> last_string(boost::begin(first_string), boost::end(first_string));
+	    symbol_range first_string = adaptor(*iter);
+	    std::vector<SymbolType> last_string(boost::begin(first_string), boost::end(first_string));
 	    
 	    stack.push_back(node(0, last_string.size()));
 	    
             for (++iter; iter != boost::end(strings); ++iter) {
-		char_range cur_string = adaptor(*iter);
+		symbol_range cur_string = adaptor(*iter);
 
                 size_t min_len = std::min(boost::size(last_string), boost::size(cur_string));
-                std::pair<const uint8_t*, std::vector<uint8_t>::const_iterator> mm = 
+                std::pair<const SymbolType*, typename std::vector<SymbolType>::const_iterator> mm = 
                     std::mismatch(cur_string.first,
                                   cur_string.first + min_len,
                                   last_string.begin());
@@ -67,7 +71,7 @@ namespace tries {
                     node& child = stack[node_idx];
                     typename TreeBuilder::representation_type subtrie = 
                         visitor.node(child.children, &last_string[0], child.path_len, child.skip);
-                    uint8_t branching_char = last_string[child.path_len - 1];
+                    SymbolType branching_char = last_string[child.path_len - 1];
                     stack[node_idx - 1].children.push_back(std::make_pair(branching_char, subtrie));
                 }
                 stack.resize(cur_node_idx + 1);
@@ -76,7 +80,7 @@ namespace tries {
                 if (mismatch < cur_node.path_len + cur_node.skip) {
                     typename TreeBuilder::representation_type subtrie = 
                         visitor.node(cur_node.children, &last_string[0], mismatch + 1, cur_node.path_len + cur_node.skip - mismatch - 1);
-                    uint8_t branching_char = last_string[mismatch];
+                    SymbolType branching_char = last_string[mismatch];
                     cur_node.children.clear();
                     cur_node.children.push_back(std::make_pair(branching_char, subtrie));
                     cur_node.skip = mismatch - cur_node.path_len;
@@ -95,7 +99,7 @@ namespace tries {
                 node& child = stack[node_idx];
                 typename TreeBuilder::representation_type subtrie = 
                         visitor.node(child.children, &last_string[0], child.path_len, child.skip);
-                uint8_t branching_char = last_string[child.path_len - 1];
+                SymbolType branching_char = last_string[child.path_len - 1];
                 stack[node_idx - 1].children.push_back(std::make_pair(branching_char, subtrie));
             }
             
@@ -118,7 +122,7 @@ namespace tries {
 	    size_t path_len;
 	    size_t skip;
             
-            typedef std::pair<uint8_t, typename TreeBuilder::representation_type> subtrie;
+            typedef std::pair<SymbolType, typename TreeBuilder::representation_type> subtrie;
             std::vector<subtrie> children;
 	};
     };
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <algorithm>
+
 #include <boost/lambda/lambda.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "repair/repair.hpp"
+#include "succinct/broadword.hpp"
 #include "succinct/elias_fano.hpp"
 #include "succinct/vbyte.hpp"
 
@@ -90,19 +97,76 @@ namespace tries {
                 assert(m_sp);
                 if (m_word_begin == m_word_end) {
                     if (m_stream_begin == m_stream_end) return 0;
-
-                    size_t code = 0;
-                    m_stream_begin += decode_vbyte(m_sp->m_byte_streams, m_stream_begin, code);
-
-                    m_word_begin = m_sp->m_word_positions[code];
-                    m_word_end = m_sp->m_word_positions[code + 1];
+                    next_word();
                 }
 
                 return m_sp->m_dictionary[m_word_begin++];
             }
 
+            // Skips the chars of the string that are equal to the
+            // first symbols of s, stopping at the first char that
+            // differs, which next() returns; this includes the
+            // terminator and the chars above the symbols range, such
+            // as the branching markers. Returns the number of chars
+            // skipped, at most len. The chars are compared a
+            // dictionary word at a time
+            template <typename Symbol>
+            size_t match(const Symbol* s, size_t len)
+            {
+                assert(m_sp);
+                size_t matched = 0;
+                while (matched < len) {
+                    if (m_word_begin == m_word_end) {
+                        if (m_stream_begin == m_stream_end) break;
+                        next_word();
+                    }
+
+                    size_t n = std::min(m_word_end - m_word_begin, len - matched);
+                    size_t word_matched = match_chars(m_sp->m_dictionary.begin() + m_word_begin, s + matched, n);
+                    m_word_begin += word_matched;
+                    matched += word_matched;
+                    if (word_matched < n) break;
+                }
+                return matched;
+            }
+
             friend struct compressed_string_pool;
         private:
+            void next_word()
+            {
+                size_t code = 0;
+                m_stream_begin += decode_vbyte(m_sp->m_byte_streams, m_stream_begin, code);
+
+                m_word_begin = m_sp->m_word_positions[code];
+                m_word_end = m_sp->m_word_positions[code + 1];
+            }
+
+            // length of the common prefix of the first n chars
+            template <typename Symbol>
+            static size_t match_chars(const char_type* word, const Symbol* s, size_t n)
+            {
+                size_t i = 0;
+                while (i < n && word[i] == s[i]) ++i;
+                return i;
+            }
+
+            static size_t match_chars(const char_type* word, const uint8_t* s, size_t n)
+            {
+                size_t i = 0;
+#if defined(__SSE2__)
+                // 8 chars at a time, widening the bytes of s
+                __m128i zero = _mm_setzero_si128();
+                for (; i + 8 <= n; i += 8) {
+                    __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(word + i));
+                    __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + i)), zero);
+                    uint64_t mismatch = uint64_t(~_mm_movemask_epi8(_mm_cmpeq_epi16(w, c)) & 0xffff);
+                    if (mismatch) return i + broadword::lsb(mismatch) / 2;
+                }
+#endif
+                while (i < n && word[i] == s[i]) ++i;
+                return i;
+            }
+
             string_enumerator(compressed_string_pool const* sp, size_t idx)
                 : m_sp(sp)
                 , m_word_begin(0)
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "bit_strings.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Deterministic automaton over bytes, compiled from a glob pattern
+    // or a small regular expression. Patterns match whole keys.
+    //
+    // Regular expressions support literals, '.', character classes
+    // ([a-z], [^0-9]), grouping, '|', '*', '+', '?' and '\' escapes.
+    // Globs support '*', '?', classes ([a-z], [!0-9]) and '\' escapes.
+    //
+    // This is also the interface expected by path_decomposed_trie::match:
+    // state_type, initial_state(), next(), is_dead(), is_final()
+    struct dfa {
+
+        typedef uint32_t state_type;
+
+        enum pattern_syntax {
+            regex_syntax,
+            glob_syntax
+        };
+
+        dfa()
+        {}
+
+        dfa(std::string const& pattern, pattern_syntax syntax = regex_syntax)
+        {
+            nfa n;
+            if (syntax == glob_syntax) {
+                n.build(glob_to_regex(pattern));
+            } else {
+                n.build(pattern);
+            }
+            determinize(n);
+        }
+
+        state_type initial_state() const
+        {
+            return 1;
+        }
+
+        state_type next(state_type state, uint8_t c) const
+        {
+            return m_transitions[state * 256 + c];
+        }
+
+        // no key can be accepted from a dead state
+        bool is_dead(state_type state) const
+        {
+            return state == dead_state;
+        }
+
+        bool is_final(state_type state) const
+        {
+            return m_final[state];
+        }
+
+        size_t num_states() const
+        {
+            return m_final.size();
+        }
+
+        template <typename T, typename Adaptor>
+        bool matches(T const& val, Adaptor adaptor) const
+        {
+            char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // ignore the terminator
+
+            state_type state = initial_state();
+            for (size_t i = 0; i < len && !is_dead(state); ++i) {
+                state = next(state, s.first[i]);
+            }
+            return is_final(state);
+        }
+
+        template <typename T>
+        bool matches(T const& val) const
+        {
+            return matches(val, stl_string_adaptor());
+        }
+
+    private:
+
+        static const state_type dead_state = 0;
+
+        // Thompson construction: every state has at most one byte-set
+        // transition and any number of epsilon transitions
+        struct nfa
+        {
+            struct state
+            {
+                state()
+                    : target(-1)
+                {}
+
+                std::vector<bool> chars;
+                size_t target;
+                std::vector<size_t> epsilon;
+            };
+
+            typedef std::pair<size_t, size_t> fragment; // (start, end)
+
+            void build(std::string const& pattern)
+            {
+                m_pattern = pattern;
+                m_pos = 0;
+                fragment f = parse_alternation();
+                if (m_pos != m_pattern.size()) {
+                    throw std::invalid_argument("Unbalanced parenthesis in pattern");
+                }
+                start = f.first;
+                accept = f.second;
+            }
+
+            // extends the set to its epsilon closure and sorts it
+            void closure(std::vector<size_t>& set) const
+            {
+                std::vector<bool> seen(states.size());
+                std::vector<size_t> stack(set);
+                for (size_t i = 0; i < set.size(); ++i) seen[set[i]] = true;
+                while (!stack.empty()) {
+                    size_t s = stack.back();
+                    stack.pop_back();
+                    for (size_t i = 0; i < states[s].epsilon.size(); ++i) {
+                        size_t t = states[s].epsilon[i];
+                        if (!seen[t]) {
+                            seen[t] = true;
+                            set.push_back(t);
+                            stack.push_back(t);
+                        }
+                    }
+                }
+                std::sort(set.begin(), set.end());
+            }
+
+            std::vector<state> states;
+            size_t start, accept;
+
+        private:
+
+            size_t new_state()
+            {
+                states.push_back(state());
+                return states.size() - 1;
+            }
+
+            fragment chars_fragment(std::vector<bool> const& chars)
+            {
+                size_t s = new_state();
+                size_t e = new_state();
+                states[s].chars = chars;
+                states[s].target = e;
+                return fragment(s, e);
+            }
+
+            fragment empty_fragment()
+            {
+                size_t s = new_state();
+                size_t e = new_state();
+                states[s].epsilon.push_back(e);
+                return fragment(s, e);
+            }
+
+            bool at(char c) const
+            {
+                return m_pos < m_pattern.size() && m_pattern[m_pos] == c;
+            }
+
+            fragment parse_alternation()
+            {
+                fragment f = parse_concatenation();
+                while (at('|')) {
+                    m_pos += 1;
+                    fragment g = parse_concatenation();
+                    size_t s = new_state();
+                    size_t e = new_state();
+                    states[s].epsilon.push_back(f.first);
+                    states[s].epsilon.push_back(g.first);
+                    states[f.second].epsilon.push_back(e);
+                    states[g.second].epsilon.push_back(e);
+                    f = fragment(s, e);
+                }
+                return f;
+            }
+
+            fragment parse_concatenation()
+            {
+                fragment f = empty_fragment();
+                while (m_pos < m_pattern.size() && !at('|') && !at(')')) {
+                    fragment g = parse_repetition();
+                    states[f.second].epsilon.push_back(g.first);
+                    f.second = g.second;
+                }
+                return f;
+            }
+
+            fragment parse_repetition()
+            {
+                fragment f = parse_atom();
+                while (at('*') || at('+') || at('?')) {
+                    char op = m_pattern[m_pos++];
+                    size_t s = new_state();
+                    size_t e = new_state();
+                    states[s].epsilon.push_back(f.first);
+                    states[f.second].epsilon.push_back(e);
+                    if (op != '+') states[s].epsilon.push_back(e);
+                    if (op != '?') states[f.second].epsilon.push_back(f.first);
+                    f = fragment(s, e);
+                }
+                return f;
+            }
+
+            fragment parse_atom()
+            {
+                char c = m_pattern[m_pos++];
+                std::vector<bool> chars(256);
+                switch (c) {
+                case '(': {
+                    fragment f = parse_alternation();
+                    if (!at(')')) throw std::invalid_argument("Unbalanced parenthesis in pattern");
+                    m_pos += 1;
+                    return f;
+                }
+                case '.':
+                    chars.assign(256, true);
+                    chars[0] = false;
+                    return chars_fragment(chars);
+                case '[':
+                    parse_class(chars);
+                    return chars_fragment(chars);
+                case '*': case '+': case '?': case ')':
+                    throw std::invalid_argument("Unexpected operator in pattern");
+                case '\\':
+                    if (m_pos == m_pattern.size()) throw std::invalid_argument("Trailing escape in pattern");
+                    c = m_pattern[m_pos++];
+                    // fall through
+                default:
+                    chars[uint8_t(c)] = true;
+                    return chars_fragment(chars);
+                }
+            }
+
+            void parse_class(std::vector<bool>& chars)
+            {
+                bool negated = at('^');
+                if (negated) m_pos += 1;
+                bool first = true;
+                while (first || !at(']')) {
+                    if (m_pos == m_pattern.size()) throw std::invalid_argument("Unterminated class in pattern");
+                    first = false;
+                    uint8_t lo = class_char();
+                    uint8_t hi = lo;
+                    if (at('-') && m_pos + 1 < m_pattern.size() && m_pattern[m_pos + 1] != ']') {
+                        m_pos += 1;
+                        hi = class_char();
+                    }
+                    for (size_t c = lo; c <= hi; ++c) chars[c] = true;
+                }
+                m_pos += 1;
+                if (negated) chars.flip();
+                chars[0] = false;
+            }
+
+            uint8_t class_char()
+            {
+                if (at('\\') && m_pos + 1 < m_pattern.size()) m_pos += 1;
+                return uint8_t(m_pattern[m_pos++]);
+            }
+
+            std::string m_pattern;
+            size_t m_pos;
+        };
+
+        static std::string glob_to_regex(std::string const& glob)
+        {
+            std::string ret;
+            for (size_t i = 0; i < glob.size(); ++i) {
+                char c = glob[i];
+                if (c == '*') {
+                    ret += ".*";
+                } else if (c == '?') {
+                    ret += '.';
+                } else if (c == '[') {
+                    size_t end = i + 1;
+                    if (end < glob.size() && (glob[end] == '!' || glob[end] == '^')) ++end;
+                    if (end < glob.size() && glob[end] == ']') ++end;
+                    while (end < glob.size() && glob[end] != ']') {
+                        if (glob[end] == '\\') ++end;
+                        ++end;
+                    }
+                    if (end >= glob.size()) throw std::invalid_argument("Unterminated class in pattern");
+                    ret += '[';
+                    size_t j = i + 1;
+                    if (glob[j] == '!') {
+                        ret += '^';
+                        ++j;
+                    }
+                    ret.append(glob, j, end - j + 1);
+                    i = end;
+                } else if (c == '\\' && i + 1 < glob.size()) {
+                    ret += '\\';
+                    ret += glob[++i];
+                } else {
+                    if (std::string("\\.[]()|*+?^").find(c) != std::string::npos) ret += '\\';
+                    ret += c;
+                }
+            }
+            return ret;
+        }
+
+        // subset construction; state 0 is the empty set (dead state)
+        // and state 1 the closure of the start state
+        void determinize(nfa const& n)
+        {
+            typedef std::vector<size_t> subset;
+            std::map<subset, state_type> ids;
+            std::vector<subset> subsets;
+
+            subsets.push_back(subset());
+            ids[subset()] = state_type(dead_state);
+            subset initial(1, n.start);
+            n.closure(initial);
+            ids[initial] = state_type(subsets.size());
+            subsets.push_back(initial);
+
+            std::vector<state_type> transitions;
+            std::vector<bool> final;
+            for (size_t i = 0; i < subsets.size(); ++i) {
+                transitions.resize((i + 1) * 256, state_type(dead_state));
+                final.push_back(std::binary_search(subsets[i].begin(), subsets[i].end(), n.accept));
+                if (i == dead_state) continue;
+
+                for (size_t c = 0; c < 256; ++c) {
+                    subset target;
+                    for (size_t j = 0; j < subsets[i].size(); ++j) {
+                        nfa::state const& s = n.states[subsets[i][j]];
+                        if (s.target != size_t(-1) && s.chars[c]) {
+                            target.push_back(s.target);
+                        }
+                    }
+                    if (target.empty()) continue;
+                    std::sort(target.begin(), target.end());
+                    target.erase(std::unique(target.begin(), target.end()), target.end());
+                    n.closure(target);
+
+                    std::map<subset, state_type>::const_iterator it = ids.find(target);
+                    state_type id;
+                    if (it == ids.end()) {
+                        id = state_type(subsets.size());
+                        ids[target] = id;
+                        subsets.push_back(target);
+                    } else {
+                        id = it->second;
+                    }
+                    transitions[i * 256 + c] = id;
+                }
+            }
+
+            m_transitions.swap(transitions);
+            m_final.swap(final);
+        }
+
+        std::vector<state_type> m_transitions;
+        std::vector<bool> m_final;
+    };
+
+}
+}
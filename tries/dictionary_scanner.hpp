@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+
+#include "bit_strings.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Finds the keys of a trie occurring in a text, either all the
+    // occurrences or a leftmost-longest segmentation. Trie must
+    // provide visit_prefixes() and get_key_enumerator().
+    //
+    // At each start position the keys that are prefixes of the
+    // remaining text are found in a single descent. Most positions
+    // start no key at all, so a bitmap of the first two bytes of the
+    // keys (and one of the first byte of the single-byte keys) skips
+    // them without touching the trie. The bitmaps take 8KB and are
+    // built with one pass over the keys; the trie must outlive the
+    // scanner
+    template <typename Trie>
+    struct dictionary_scanner
+    {
+        typedef Trie trie_type;
+
+        dictionary_scanner(Trie const& trie)
+            : m_trie(trie)
+            , m_single_bytes(256 / 64)
+            , m_bigrams(65536 / 64)
+        {
+            typename Trie::key_enumerator e = trie.get_key_enumerator();
+            for (size_t i = 0; i < trie.size(); ++i) {
+                std::string const& key = e.next();
+                if (key.size() == 1) {
+                    set_bit(m_single_bytes, uint8_t(key[0]));
+                } else if (key.size() > 1) {
+                    set_bit(m_bigrams, bigram(reinterpret_cast<const uint8_t*>(key.data())));
+                }
+            }
+        }
+
+        // Calls visitor(pos, length, id) for every occurrence of a
+        // (non-empty) key in the len bytes at text, by increasing
+        // position and, for the same position, increasing length
+        template <typename Visitor>
+        void find_all(const uint8_t* text, size_t len, Visitor& visitor) const
+        {
+            for (size_t pos = 0; pos < len; ++pos) {
+                if (!may_start(text + pos, len - pos)) continue;
+                occurrences_visitor<Visitor> v(pos, visitor);
+                m_trie.visit_prefixes(text + pos, len - pos, v);
+            }
+        }
+
+        // Calls visitor(pos, length, id) for the leftmost-longest
+        // segmentation of the text: at each position the longest key
+        // starting there is taken and the scan resumes after it;
+        // positions that start no key are skipped
+        template <typename Visitor>
+        void segment(const uint8_t* text, size_t len, Visitor& visitor) const
+        {
+            size_t pos = 0;
+            while (pos < len) {
+                if (may_start(text + pos, len - pos)) {
+                    longest_visitor v;
+                    m_trie.visit_prefixes(text + pos, len - pos, v);
+                    if (v.m_length) {
+                        visitor(pos, v.m_length, v.m_idx);
+                        pos += v.m_length;
+                        continue;
+                    }
+                }
+                pos += 1;
+            }
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+    private:
+
+        static size_t bigram(const uint8_t* s)
+        {
+            return (size_t(s[0]) << 8) | s[1];
+        }
+
+        static void set_bit(std::vector<uint64_t>& bits, size_t pos)
+        {
+            bits[pos / 64] |= uint64_t(1) << (pos % 64);
+        }
+
+        static bool get_bit(std::vector<uint64_t> const& bits, size_t pos)
+        {
+            return (bits[pos / 64] >> (pos % 64)) & 1;
+        }
+
+        bool may_start(const uint8_t* s, size_t len) const
+        {
+            return get_bit(m_single_bytes, s[0])
+                || (len > 1 && get_bit(m_bigrams, bigram(s)));
+        }
+
+        template <typename Visitor>
+        struct occurrences_visitor
+        {
+            occurrences_visitor(size_t pos, Visitor& visitor)
+                : m_pos(pos)
+                , m_visitor(visitor)
+            {}
+
+            void operator()(size_t idx, size_t length)
+            {
+                if (length) m_visitor(m_pos, length, idx);
+            }
+
+        private:
+            size_t m_pos;
+            Visitor& m_visitor;
+        };
+
+        struct longest_visitor
+        {
+            longest_visitor()
+                : m_idx(-1)
+                , m_length(0)
+            {}
+
+            void operator()(size_t idx, size_t length)
+            {
+                m_idx = idx;
+                m_length = length;
+            }
+
+            size_t m_idx;
+            size_t m_length;
+        };
+
+        Trie const& m_trie;
+        std::vector<uint64_t> m_single_bytes;
+        std::vector<uint64_t> m_bigrams;
+    };
+
+}
+}
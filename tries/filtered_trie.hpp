@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+
+#include <boost/range.hpp>
+
+#include "bit_strings.hpp"
+#include "string_hash.hpp"
+#include "xor_filter.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Trie with an xor filter of its keys in front of index(), so that
+    // most of the strings that are not keys are rejected with three
+    // byte accesses instead of a traversal. Worth it when most of the
+    // queries miss; the filter costs about 10 bits per key and is
+    // mapped and frozen together with the trie
+    template <typename Trie>
+    struct filtered_trie
+    {
+        typedef Trie trie_type;
+
+        filtered_trie()
+        {}
+
+	template <typename Range, typename Adaptor>
+        filtered_trie(Range const& strings, Adaptor adaptor)
+        {
+            build(strings, adaptor);
+        }
+
+	template <typename Range>
+        filtered_trie(Range const& strings)
+        {
+            build(strings, stl_string_adaptor());
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+            if (!m_filter.contains(key_hash(adaptor(val)))) return size_t(-1);
+            return m_trie.index(val, adaptor);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        std::string operator[](size_t idx) const
+        {
+            return m_trie[idx];
+        }
+
+        size_t size() const
+        {
+            return m_trie.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+        xor_filter const& get_filter() const
+        {
+            return m_filter;
+        }
+
+	void swap(filtered_trie& other)
+        {
+            m_trie.swap(other.m_trie);
+            m_filter.swap(other.m_filter);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_trie, "m_trie")
+                (m_filter, "m_filter")
+		;
+        }
+
+    private:
+
+        static uint64_t key_hash(char_range s)
+        {
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // hash with or without terminator alike
+            return hash_bytes(s.first, len);
+        }
+
+	template <typename Range, typename Adaptor>
+        void build(Range const& strings, Adaptor adaptor)
+        {
+            // the tries cannot be built on an empty set, but then the
+            // filter rejects every string before the trie is queried
+            if (boost::empty(strings)) return;
+            Trie(strings, adaptor).swap(m_trie);
+
+            std::vector<uint64_t> hashes;
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            for (iterator_t iter = boost::begin(strings); iter != boost::end(strings); ++iter) {
+                hashes.push_back(key_hash(adaptor(*iter)));
+            }
+            xor_filter(hashes).swap(m_filter);
+        }
+
+        trie_type m_trie;
+        xor_filter m_filter;
+    };
+
+}
+}
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "succinct/broadword.hpp"
+#include "succinct/elias_fano.hpp"
+#include "succinct/util.hpp"
+#include "succinct/vbyte.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // String pool that encodes the strings with a static table of up
+    // to 255 symbols of 1 to 8 bytes, in the style of FSST. Each byte
+    // of the encoding is either the code of a symbol, decoded with a
+    // single table lookup, or the escape code followed by a literal
+    // char as a vbyte; the chars that are not bytes (the branching
+    // markers) are always literals.
+    //
+    // The table is trained on a sample of the strings: each round
+    // parses the sample with the current table, and keeps the symbols
+    // and the concatenations of two adjacent symbols that cover the
+    // most bytes. The symbols are held in 64-bit words, so they are
+    // decoded and compared with the strings 8 bytes at a time
+    // (assuming a little-endian machine)
+    struct fsst_string_pool {
+
+        typedef uint16_t char_type;
+
+        static const uint8_t escape_code = 255;
+
+        fsst_string_pool() {}
+
+	template <typename Range>
+        fsst_string_pool(Range const& strings_seq)
+        {
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+
+            // sample every k-th string
+            size_t n = 0, total_len = 0;
+            for (iterator_t iter = boost::begin(strings_seq); iter != boost::end(strings_seq); ++iter) {
+                if (!*iter) ++n;
+                else ++total_len;
+            }
+            size_t stride = std::max(total_len / sample_len, size_t(1));
+
+            std::vector<std::string> sample;
+            std::string segment;
+            size_t string_idx = 0;
+            for (iterator_t iter = boost::begin(strings_seq); iter != boost::end(strings_seq); ++iter) {
+                size_t c = *iter;
+                if (c && c < 256) {
+                    if (string_idx % stride == 0) segment.push_back(char(c));
+                    continue;
+                }
+                if (segment.size()) sample.push_back(segment);
+                segment.clear();
+                if (!c) ++string_idx;
+            }
+
+            std::vector<std::string> symbols;
+            train(sample, symbols);
+            util::dispose(sample);
+
+            std::vector<uint64_t> symbol_words(symbols.size());
+            std::vector<uint8_t> symbol_lengths(symbols.size());
+            for (size_t i = 0; i < symbols.size(); ++i) {
+                for (size_t j = 0; j < symbols[i].size(); ++j) {
+                    symbol_words[i] |= uint64_t(uint8_t(symbols[i][j])) << (8 * j);
+                }
+                symbol_lengths[i] = uint8_t(symbols[i].size());
+            }
+            m_symbols.steal(symbol_words);
+            m_symbol_lengths.steal(symbol_lengths);
+
+            symbol_index index(symbols);
+            std::vector<uint8_t> codes;
+            std::vector<size_t> positions;
+            positions.push_back(0);
+            for (iterator_t iter = boost::begin(strings_seq); iter != boost::end(strings_seq); ++iter) {
+                size_t c = *iter;
+                if (c && c < 256) {
+                    segment.push_back(char(c));
+                    continue;
+                }
+                encode_segment(index, symbols, segment, codes);
+                segment.clear();
+                if (c) {
+                    codes.push_back(uint8_t(escape_code));
+                    append_vbyte(codes, c);
+                } else {
+                    positions.push_back(codes.size());
+                }
+            }
+            assert(positions.size() == n + 1);
+
+            elias_fano::elias_fano_builder positions_builder(positions.back() + 1, positions.size());
+            for (size_t i = 0; i < positions.size(); ++i) {
+                positions_builder.push_back(positions[i]);
+            }
+
+            m_codes.steal(codes);
+            elias_fano(&positions_builder, false).swap(m_positions);
+        }
+
+        size_t size() const
+        {
+            return m_positions.num_ones() - 1;
+        }
+
+        // Number of symbols in the table
+        size_t symbols() const
+        {
+            return m_symbols.size();
+        }
+
+        struct string_enumerator
+        {
+            string_enumerator()
+                : m_sp(0)
+            {}
+
+            char_type next()
+            {
+                assert(m_sp);
+                if (!m_symbol_len) {
+                    if (m_begin == m_end) return 0;
+
+                    uint8_t code = m_sp->m_codes[m_begin++];
+                    if (code == escape_code) {
+                        size_t c = 0;
+                        m_begin += decode_vbyte(m_sp->m_codes, m_begin, c);
+                        return char_type(c);
+                    }
+                    m_symbol = m_sp->m_symbols[code];
+                    m_symbol_len = m_sp->m_symbol_lengths[code];
+                }
+
+                char_type c = char_type(m_symbol & 0xFF);
+                m_symbol >>= 8;
+                m_symbol_len -= 1;
+                return c;
+            }
+
+            // Skips the chars of the string that are equal to the
+            // first symbols of s, stopping at the first char that
+            // differs, which next() returns. Returns the number of
+            // chars skipped, at most len
+            template <typename Symbol>
+            size_t match(const Symbol* s, size_t len)
+            {
+                assert(m_sp);
+                size_t matched = 0;
+                while (matched < len) {
+                    if (!m_symbol_len) {
+                        if (m_begin == m_end) break;
+
+                        uint8_t code = m_sp->m_codes[m_begin];
+                        if (code == escape_code) {
+                            // consume the literal only if it matches
+                            size_t c = 0;
+                            size_t c_len = decode_vbyte(m_sp->m_codes, m_begin + 1, c);
+                            if (c != s[matched]) break;
+                            m_begin += 1 + c_len;
+                            matched += 1;
+                            continue;
+                        }
+                        m_begin += 1;
+                        m_symbol = m_sp->m_symbols[code];
+                        m_symbol_len = m_sp->m_symbol_lengths[code];
+                    }
+
+                    size_t n = std::min(size_t(m_symbol_len), len - matched);
+                    size_t symbol_matched = match_symbol(m_symbol, s + matched, n, len - matched);
+                    m_symbol = symbol_matched < 8 ? m_symbol >> (8 * symbol_matched) : 0;
+                    m_symbol_len -= symbol_matched;
+                    matched += symbol_matched;
+                    if (symbol_matched < n) break;
+                }
+                return matched;
+            }
+
+            friend struct fsst_string_pool;
+        private:
+            // length of the common prefix of the first n bytes of the
+            // symbol and of s, which has avail readable symbols
+            template <typename Symbol>
+            static size_t match_symbol(uint64_t symbol, const Symbol* s, size_t n, size_t /* avail */)
+            {
+                size_t i = 0;
+                while (i < n && (symbol & 0xFF) == s[i]) {
+                    symbol >>= 8;
+                    ++i;
+                }
+                return i;
+            }
+
+            static size_t match_symbol(uint64_t symbol, const uint8_t* s, size_t n, size_t avail)
+            {
+                if (avail >= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, s, 8);
+                    uint64_t diff = symbol ^ word;
+                    if (n < 8) diff &= (uint64_t(1) << (8 * n)) - 1;
+                    return diff ? broadword::lsb(diff) / 8 : n;
+                }
+                return match_symbol<uint8_t>(symbol, s, n, avail);
+            }
+
+            string_enumerator(fsst_string_pool const* sp, size_t idx)
+                : m_sp(sp)
+                , m_symbol(0)
+                , m_symbol_len(0)
+            {
+                std::pair<uint64_t, uint64_t> string_range = m_sp->m_positions.select_range(idx);
+                m_begin = string_range.first;
+                m_end = string_range.second;
+                m_sp->m_codes.prefetch(m_begin);
+            }
+
+            fsst_string_pool const* m_sp;
+            size_t m_begin, m_end;
+            uint64_t m_symbol; // bytes of the current symbol not returned yet
+            size_t m_symbol_len;
+        };
+
+        string_enumerator get_string_enumerator(size_t idx) const
+        {
+            return string_enumerator(this, idx);
+        }
+
+        std::string get_string(size_t idx) const
+        {
+            // only for debug
+            std::ostringstream os;
+            string_enumerator e = get_string_enumerator(idx);
+            size_t c;
+            while ((c = e.next()) != 0) {
+                if (c >= 32 && c < 256) {
+                    os << (char)c;
+                } else {
+                    os << '[' << c << ']';
+                }
+            }
+            return os.str();
+        }
+
+        void swap(fsst_string_pool& other)
+        {
+            m_symbols.swap(other.m_symbols);
+            m_symbol_lengths.swap(other.m_symbol_lengths);
+            m_codes.swap(other.m_codes);
+            m_positions.swap(other.m_positions);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_symbols, "m_symbols")
+                (m_symbol_lengths, "m_symbol_lengths")
+                (m_codes, "m_codes")
+                (m_positions, "m_positions")
+                ;
+        }
+
+    protected:
+
+        static const size_t max_symbols = 255;
+        static const size_t max_symbol_len = 8;
+        static const size_t sample_len = 1 << 18;
+        static const size_t training_rounds = 5;
+
+        // codes of the symbols by first byte, longest first
+        struct symbol_index
+        {
+            symbol_index(std::vector<std::string> const& symbols)
+                : m_symbols(symbols)
+                , m_codes(256)
+            {
+                std::vector<std::pair<size_t, size_t> > by_length; // (length, code)
+                for (size_t i = 0; i < symbols.size(); ++i) {
+                    by_length.push_back(std::make_pair(symbols[i].size(), i));
+                }
+                std::sort(by_length.begin(), by_length.end(), std::greater<std::pair<size_t, size_t> >());
+                for (size_t i = 0; i < by_length.size(); ++i) {
+                    size_t code = by_length[i].second;
+                    m_codes[uint8_t(symbols[code][0])].push_back(code);
+                }
+            }
+
+            // code of the longest symbol at pos, or -1 if none
+            size_t find_longest(std::string const& s, size_t pos) const
+            {
+                std::vector<size_t> const& codes = m_codes[uint8_t(s[pos])];
+                for (size_t i = 0; i < codes.size(); ++i) {
+                    std::string const& symbol = m_symbols[codes[i]];
+                    if (symbol.size() <= s.size() - pos
+                        && !s.compare(pos, symbol.size(), symbol)) {
+                        return codes[i];
+                    }
+                }
+                return -1;
+            }
+
+        private:
+            std::vector<std::string> const& m_symbols;
+            std::vector<std::vector<size_t> > m_codes;
+        };
+
+        static void train(std::vector<std::string> const& sample, std::vector<std::string>& symbols)
+        {
+            // while counting, byte b not covered by a symbol has code
+            // max_symbols + b
+            size_t n_codes = max_symbols + 256;
+            symbols.clear();
+
+            for (size_t round = 0; round < training_rounds; ++round) {
+                symbol_index index(symbols);
+                std::vector<size_t> counts(n_codes);
+                std::vector<size_t> pair_counts(n_codes * n_codes);
+                for (size_t i = 0; i < sample.size(); ++i) {
+                    std::string const& s = sample[i];
+                    size_t prev = -1;
+                    for (size_t pos = 0; pos < s.size(); ) {
+                        size_t code = index.find_longest(s, pos);
+                        if (code == size_t(-1)) {
+                            code = max_symbols + uint8_t(s[pos]);
+                            pos += 1;
+                        } else {
+                            pos += symbols[code].size();
+                        }
+                        counts[code] += 1;
+                        if (prev != size_t(-1)) pair_counts[prev * n_codes + code] += 1;
+                        prev = code;
+                    }
+                }
+
+                // the gain of a candidate is the number of bytes it
+                // would have covered
+                std::map<std::string, size_t> gains;
+                for (size_t c1 = 0; c1 < n_codes; ++c1) {
+                    if (!counts[c1]) continue;
+                    std::string s1 = code_string(symbols, c1);
+                    gains[s1] += counts[c1] * s1.size();
+                    for (size_t c2 = 0; c2 < n_codes; ++c2) {
+                        size_t count = pair_counts[c1 * n_codes + c2];
+                        if (!count) continue;
+                        std::string s2 = code_string(symbols, c2);
+                        if (s1.size() + s2.size() > max_symbol_len) continue;
+                        gains[s1 + s2] += count * (s1.size() + s2.size());
+                    }
+                }
+
+                std::vector<std::pair<size_t, std::string> > candidates;
+                for (std::map<std::string, size_t>::const_iterator iter = gains.begin(); iter != gains.end(); ++iter) {
+                    candidates.push_back(std::make_pair(iter->second, iter->first));
+                }
+                size_t n_symbols = std::min(candidates.size(), size_t(max_symbols));
+                std::partial_sort(candidates.begin(), candidates.begin() + n_symbols, candidates.end(),
+                                  std::greater<std::pair<size_t, std::string> >());
+
+                symbols.clear();
+                for (size_t i = 0; i < n_symbols; ++i) {
+                    symbols.push_back(candidates[i].second);
+                }
+            }
+        }
+
+        static std::string code_string(std::vector<std::string> const& symbols, size_t code)
+        {
+            if (code < symbols.size()) return symbols[code];
+            return std::string(1, char(code - max_symbols));
+        }
+
+        // greedy longest-match parsing
+        static void encode_segment(symbol_index const& index, std::vector<std::string> const& symbols,
+                                   std::string const& segment, std::vector<uint8_t>& codes)
+        {
+            for (size_t pos = 0; pos < segment.size(); ) {
+                size_t code = index.find_longest(segment, pos);
+                if (code == size_t(-1)) {
+                    codes.push_back(uint8_t(escape_code));
+                    append_vbyte(codes, uint8_t(segment[pos]));
+                    pos += 1;
+                } else {
+                    codes.push_back(uint8_t(code));
+                    pos += symbols[code].size();
+                }
+            }
+        }
+
+        mapper::mappable_vector<uint64_t> m_symbols;
+        mapper::mappable_vector<uint8_t> m_symbol_lengths;
+
+        mapper::mappable_vector<uint8_t> m_codes;
+        elias_fano m_positions;
+    };
+
+}
+}
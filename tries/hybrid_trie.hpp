@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "bit_strings.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Lookup front-end for a (typically memory-mapped) trie: a jump
+    // table indexed by the first one or two bytes of the string gives
+    // the entry point where the lookup resumes, skipping the top
+    // levels that every query would visit, and rejects immediately the
+    // strings whose prefix starts no key. The table is built when the
+    // wrapper is created, so the trie format is unchanged; Trie must
+    // provide prefix_entry_point() and index_from(), and must outlive
+    // the wrapper. With two bytes the table has 65536 entries
+    template <typename Trie>
+    struct hybrid_trie
+    {
+        typedef Trie trie_type;
+        typedef typename Trie::entry_point entry_point;
+
+        hybrid_trie(Trie const& trie, size_t prefix_bytes = 2)
+            : m_trie(trie)
+            , m_prefix_bytes(prefix_bytes)
+        {
+            assert(prefix_bytes == 1 || prefix_bytes == 2);
+            m_entry_points.resize(size_t(1) << (8 * prefix_bytes));
+
+            std::string prefix(prefix_bytes, '\0');
+            for (size_t i = 0; i < m_entry_points.size(); ++i) {
+                entry_point& ep = m_entry_points[i];
+                ep.node_pos = 0; // no key starts with the prefix
+                for (size_t j = 0; j < prefix_bytes; ++j) {
+                    prefix[j] = char(i >> (8 * (prefix_bytes - 1 - j)));
+                }
+                // prefixes with a 0 are not looked up in the table
+                if (prefix.find('\0') != std::string::npos) continue;
+                if (!trie.prefix_entry_point(prefix, ep)) {
+                    ep.node_pos = 0;
+                }
+            }
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len <= m_prefix_bytes) return m_trie.index(val, adaptor);
+
+            size_t table_idx = 0;
+            for (size_t j = 0; j < m_prefix_bytes; ++j) {
+                if (!s.first[j]) return m_trie.index(val, adaptor);
+                table_idx = (table_idx << 8) | s.first[j];
+            }
+
+            entry_point const& ep = m_entry_points[table_idx];
+            if (!ep.node_pos) return size_t(-1);
+            return m_trie.index_from(ep, val, adaptor);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        std::string operator[](size_t idx) const
+        {
+            return m_trie[idx];
+        }
+
+        size_t size() const
+        {
+            return m_trie.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+    private:
+        Trie const& m_trie;
+        size_t m_prefix_bytes;
+        std::vector<entry_point> m_entry_points;
+    };
+
+}
+}
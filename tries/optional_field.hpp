@@ -0,0 +1,28 @@
+#pragma once
+
+namespace succinct {
+namespace tries {
+
+    // Maps a field of a structure only if the feature that uses it is
+    // enabled at compile time, so that the structures with the feature
+    // disabled keep the file format they had without it
+    template <bool Enabled>
+    struct optional_field
+    {
+        template <typename Visitor, typename T>
+        static void map(Visitor& visit, T& field, const char* name)
+        {
+            visit(field, name);
+        }
+    };
+
+    template <>
+    struct optional_field<false>
+    {
+        template <typename Visitor, typename T>
+        static void map(Visitor& /* visit */, T& /* field */, const char* /* name */)
+        {}
+    };
+
+}
+}
@@ -0,0 +1,429 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "succinct/mappable_vector.hpp"
+
+#include "packed_vector.hpp"
+#include "path_decomposed_trie.hpp"
+#include "vbyte_string_pool.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Same trie, and the same ids, as path_decomposed_trie, with a
+    // pointer-based layout where a lookup reads one record per
+    // centroid path instead of the bp, the branching chars and the
+    // labels pool. Each node is a record holding its degree, the
+    // branching groups, the branching chars, the offsets of the child
+    // records and the head of its label; only the tail of long labels
+    // is stored in a separate array. Records are laid out in id order
+    // on a 64-byte grid, and do not cross a grid boundary unless they
+    // are larger than 64 bytes, so that a lookup misses the cache once
+    // per level. The mapper aligns the fields only to 8 bytes, so when
+    // the records are not 64-byte aligned they are copied into an
+    // aligned buffer after building or mapping (which then costs
+    // memory outside of the mapped file).
+    //
+    // Record layout, with unaligned fields:
+    //   u32 id, u32 parent record offset, u16 index in the parent,
+    //   u16 degree, u16 number of groups, u32 label length,
+    //   u16 label head length,
+    //   groups x (u32 label position, u16 size),
+    //   degree x u8 branching char, degree x u32 child record offset,
+    //   label head, [u32 label tail offset, if the head is shorter]
+    template <bool Lexicographic = false>
+    struct packed_path_decomposed_trie
+    {
+        packed_path_decomposed_trie()
+            : m_records_base(0)
+            , m_records_source(0)
+	{}
+
+	template <typename Range, typename Adaptor>
+	packed_path_decomposed_trie(Range const& strings, Adaptor adaptor)
+            : m_records_base(0)
+            , m_records_source(0)
+	{
+            path_decomposed_trie<vbyte_string_pool, Lexicographic> trie(strings, adaptor);
+            build(trie);
+	}
+
+	template <typename Range>
+	packed_path_decomposed_trie(Range const& strings)
+            : m_records_base(0)
+            , m_records_source(0)
+	{
+            path_decomposed_trie<vbyte_string_pool, Lexicographic> trie(strings);
+            build(trie);
+	}
+
+        // Converts an existing trie; the ids are preserved
+        template <typename LabelsPoolType, bool FirstLabelChars>
+        explicit packed_path_decomposed_trie(path_decomposed_trie<LabelsPoolType, Lexicographic, FirstLabelChars> const& trie)
+            : m_records_base(0)
+            , m_records_source(0)
+        {
+            build(trie);
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+	    char_range r = adaptor(val);
+            const uint8_t* s = r.first;
+            size_t len = boost::size(r);
+
+            size_t cur_pos = 0;
+            size_t offset = 0;
+            record rec;
+            while (true) {
+                read_record(offset, rec);
+                if (cur_pos == len) return rec.id; // assume the string is null-terminated
+
+                size_t m = 0;
+                while (m < rec.label_len && cur_pos + m < len && label_char(rec, m) == s[cur_pos + m]) {
+                    ++m;
+                }
+                if (cur_pos + m == len) return size_t(-1);
+                if (m == rec.label_len && !s[cur_pos + m] && cur_pos + m + 1 == len) return rec.id;
+
+                size_t child = find_child(rec, m, s[cur_pos + m]);
+                if (child == size_t(-1)) return size_t(-1);
+                offset = read<uint32_t>(rec.children + child * sizeof(uint32_t));
+                cur_pos += m + 1;
+            }
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        std::string operator[](size_t idx) const
+        {
+            std::vector<std::pair<uint32_t, uint16_t> > ancestors; // (record offset, child index)
+            size_t offset = m_node_offsets[idx];
+            record rec;
+            read_record(offset, rec);
+            while (rec.id) {
+                ancestors.push_back(std::make_pair(rec.parent, rec.child_idx));
+                read_record(rec.parent, rec);
+            }
+
+            std::string ret;
+            for (size_t i = ancestors.size(); i != 0; --i) {
+                read_record(ancestors[i - 1].first, rec);
+                size_t child_idx = ancestors[i - 1].second;
+                size_t group_begin = 0;
+                for (size_t g = 0; g < rec.n_groups; ++g) {
+                    size_t group_size = read<uint16_t>(rec.groups + g * group_entry_size + sizeof(uint32_t));
+                    if (child_idx < group_begin + group_size) {
+                        size_t pos = read<uint32_t>(rec.groups + g * group_entry_size);
+                        append_label(rec, pos, ret);
+                        break;
+                    }
+                    group_begin += group_size;
+                }
+                uint8_t branching_char = rec.branching_chars[child_idx];
+                if (branching_char) ret.push_back(char(branching_char));
+            }
+
+            read_record(offset, rec);
+            append_label(rec, rec.label_len, ret);
+            return ret;
+        }
+
+        size_t size() const
+        {
+            return m_node_offsets.size();
+        }
+
+	void swap(packed_path_decomposed_trie& other)
+        {
+            m_records.swap(other.m_records);
+            m_label_tails.swap(other.m_label_tails);
+            m_node_offsets.swap(other.m_node_offsets);
+            m_aligned_records.swap(other.m_aligned_records);
+            std::swap(m_records_base, other.m_records_base);
+            std::swap(m_records_source, other.m_records_source);
+	}
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_records, "m_records")
+                (m_label_tails, "m_label_tails")
+                (m_node_offsets, "m_node_offsets")
+		;
+            align_records();
+        }
+
+    private:
+
+        static const size_t cache_line_size = 64;
+        static const size_t min_label_head = 8;
+        static const size_t record_header_size = 20;
+        static const size_t group_entry_size = 6;
+        static const size_t child_entry_size = 5; // branching char and offset
+
+        struct record
+        {
+            uint32_t id;
+            uint32_t parent;
+            uint16_t child_idx;
+            uint16_t deg;
+            uint16_t n_groups;
+            uint32_t label_len;
+            uint16_t head_len;
+            const uint8_t* groups;
+            const uint8_t* branching_chars;
+            const uint8_t* children;
+            const uint8_t* head;
+            uint32_t tail_offset;
+        };
+
+        template <typename T>
+        static T read(const uint8_t* p)
+        {
+            T ret;
+            std::memcpy(&ret, p, sizeof(T));
+            return ret;
+        }
+
+        template <typename T>
+        static void write(std::vector<uint8_t>& buf, size_t& pos, T val)
+        {
+            std::memcpy(&buf[pos], &val, sizeof(T));
+            pos += sizeof(T);
+        }
+
+        void read_record(size_t offset, record& rec) const
+        {
+            const uint8_t* p = m_records_base + offset;
+            rec.id = read<uint32_t>(p);
+            rec.parent = read<uint32_t>(p + 4);
+            rec.child_idx = read<uint16_t>(p + 8);
+            rec.deg = read<uint16_t>(p + 10);
+            rec.n_groups = read<uint16_t>(p + 12);
+            rec.label_len = read<uint32_t>(p + 14);
+            rec.head_len = read<uint16_t>(p + 18);
+            rec.groups = p + record_header_size;
+            rec.branching_chars = rec.groups + rec.n_groups * group_entry_size;
+            rec.children = rec.branching_chars + rec.deg;
+            rec.head = rec.children + rec.deg * sizeof(uint32_t);
+            rec.tail_offset = rec.head_len < rec.label_len ? read<uint32_t>(rec.head + rec.head_len) : 0;
+        }
+
+        uint8_t label_char(record const& rec, size_t pos) const
+        {
+            if (pos < rec.head_len) return rec.head[pos];
+            return m_label_tails[rec.tail_offset + pos - rec.head_len];
+        }
+
+        void append_label(record const& rec, size_t len, std::string& ret) const
+        {
+            for (size_t i = 0; i < len; ++i) {
+                ret.push_back(char(label_char(rec, i)));
+            }
+        }
+
+        // index of the child branching with c at label position pos,
+        // or -1 if there is none
+        size_t find_child(record const& rec, size_t pos, uint8_t c) const
+        {
+            size_t group_begin = 0;
+            for (size_t g = 0; g < rec.n_groups; ++g) {
+                size_t group_pos = read<uint32_t>(rec.groups + g * group_entry_size);
+                size_t group_size = read<uint16_t>(rec.groups + g * group_entry_size + sizeof(uint32_t));
+                if (group_pos == pos) {
+                    for (size_t i = group_begin; i < group_begin + group_size; ++i) {
+                        if (rec.branching_chars[i] == c) return i;
+                    }
+                    return size_t(-1);
+                }
+                if (group_pos > pos) break;
+                group_begin += group_size;
+            }
+            return size_t(-1);
+        }
+
+        struct node_info
+        {
+            std::string label;
+            std::vector<std::pair<size_t, size_t> > groups; // (label position, size)
+            std::vector<uint8_t> branching_chars;
+            std::vector<size_t> children;
+            size_t parent;
+            size_t child_idx;
+            size_t head_len;
+            size_t size;
+        };
+
+        template <typename Trie>
+        static void decode_node(Trie const& trie, size_t rank0, node_info& node)
+        {
+            bp_vector const& bp = trie.get_bp();
+            size_t node_pos = rank0 ? bp.select0(rank0 - 1) + 1 : 1;
+            size_t first_child_rank = node_pos - rank0 - 1;
+            size_t deg = bp.successor0(node_pos) - node_pos;
+
+            typename Trie::labels_pool_type::string_enumerator label_enumerator =
+                trie.get_labels().get_string_enumerator(rank0);
+            while (true) {
+                typename Trie::labels_pool_type::char_type c = label_enumerator.next();
+                if (!c) break;
+                if (c < 256) {
+                    node.label.push_back(char(c));
+                } else {
+                    node.groups.push_back(std::make_pair(node.label.size(), size_t(c - 256 + 1)));
+                }
+            }
+
+            for (size_t i = 0; i < deg; ++i) {
+                node.branching_chars.push_back(trie.get_branching_chars()[first_child_rank + i]);
+                size_t child_open = node_pos + i;
+                size_t child_pos = bp.find_close(child_open) + 1;
+                size_t child_first_child_rank = first_child_rank + i + (child_pos - child_open) / 2;
+                node.children.push_back(child_pos - child_first_child_rank - 1);
+            }
+        }
+
+        template <typename Trie>
+        void build(Trie const& trie)
+        {
+            size_t n = trie.size();
+            std::vector<node_info> nodes(n);
+            for (size_t rank0 = 0; rank0 < n; ++rank0) {
+                decode_node(trie, rank0, nodes[rank0]);
+            }
+            nodes[0].parent = 0;
+            nodes[0].child_idx = 0;
+            for (size_t rank0 = 0; rank0 < n; ++rank0) {
+                for (size_t i = 0; i < nodes[rank0].children.size(); ++i) {
+                    nodes[nodes[rank0].children[i]].parent = rank0;
+                    nodes[nodes[rank0].children[i]].child_idx = i;
+                }
+            }
+
+            // choose the label heads and place the records
+            std::vector<size_t> offsets(n);
+            size_t offset = 0;
+            size_t tails_size = 0;
+            for (size_t rank0 = 0; rank0 < n; ++rank0) {
+                node_info& node = nodes[rank0];
+                if (node.children.size() > std::numeric_limits<uint16_t>::max() ||
+                    node.groups.size() > std::numeric_limits<uint16_t>::max()) {
+                    throw std::length_error("Node degree too large for packed layout");
+                }
+                size_t fixed_size = size_t(record_header_size)
+                    + node.groups.size() * group_entry_size
+                    + node.children.size() * child_entry_size;
+                node.head_len = node.label.size();
+                if (fixed_size + node.label.size() > cache_line_size) {
+                    size_t available = cache_line_size > fixed_size + sizeof(uint32_t)
+                        ? cache_line_size - fixed_size - sizeof(uint32_t) : 0;
+                    node.head_len = std::min(node.label.size(), std::max(available, size_t(min_label_head)));
+                }
+                node.head_len = std::min(node.head_len, size_t(std::numeric_limits<uint16_t>::max()));
+                node.size = fixed_size + node.head_len;
+                if (node.head_len < node.label.size()) {
+                    node.size += sizeof(uint32_t);
+                    tails_size += node.label.size() - node.head_len;
+                }
+
+                size_t line_offset = offset % cache_line_size;
+                if (line_offset && line_offset + node.size > cache_line_size) {
+                    offset += cache_line_size - line_offset;
+                }
+                offsets[rank0] = offset;
+                offset += node.size;
+            }
+            if (offset > std::numeric_limits<uint32_t>::max() ||
+                tails_size > std::numeric_limits<uint32_t>::max() ||
+                n > std::numeric_limits<uint32_t>::max()) {
+                throw std::length_error("Trie too large for packed layout");
+            }
+
+            std::vector<uint8_t> records(offset);
+            std::vector<uint8_t> label_tails;
+            label_tails.reserve(tails_size);
+            for (size_t rank0 = 0; rank0 < n; ++rank0) {
+                node_info& node = nodes[rank0];
+                size_t pos = offsets[rank0];
+                write(records, pos, uint32_t(rank0));
+                write(records, pos, uint32_t(offsets[node.parent]));
+                write(records, pos, uint16_t(node.child_idx));
+                write(records, pos, uint16_t(node.children.size()));
+                write(records, pos, uint16_t(node.groups.size()));
+                write(records, pos, uint32_t(node.label.size()));
+                write(records, pos, uint16_t(node.head_len));
+                for (size_t g = 0; g < node.groups.size(); ++g) {
+                    write(records, pos, uint32_t(node.groups[g].first));
+                    write(records, pos, uint16_t(node.groups[g].second));
+                }
+                for (size_t i = 0; i < node.children.size(); ++i) {
+                    write(records, pos, node.branching_chars[i]);
+                }
+                for (size_t i = 0; i < node.children.size(); ++i) {
+                    write(records, pos, uint32_t(offsets[node.children[i]]));
+                }
+                for (size_t i = 0; i < node.head_len; ++i) {
+                    write(records, pos, uint8_t(node.label[i]));
+                }
+                if (node.head_len < node.label.size()) {
+                    write(records, pos, uint32_t(label_tails.size()));
+                    label_tails.insert(label_tails.end(), node.label.begin() + node.head_len, node.label.end());
+                }
+                assert(pos == offsets[rank0] + node.size);
+
+                std::string().swap(node.label);
+            }
+
+            mapper::mappable_vector<uint8_t>(records).swap(m_records);
+            mapper::mappable_vector<uint8_t>(label_tails).swap(m_label_tails);
+            packed_vector(offsets).swap(m_node_offsets);
+            align_records();
+        }
+
+        // Points m_records_base to the records if they are 64-byte
+        // aligned, otherwise to an aligned copy of them. Called after
+        // m_records is built or mapped, and does nothing if it did not
+        // move since the last call
+        void align_records()
+        {
+            const uint8_t* records = m_records.begin();
+            if (records == m_records_source) return;
+            m_records_source = records;
+
+            if (size_t(records) % cache_line_size == 0) {
+                std::vector<uint8_t>().swap(m_aligned_records);
+                m_records_base = records;
+            } else {
+                m_aligned_records.assign(m_records.size() + cache_line_size, 0);
+                size_t misalignment = size_t(&m_aligned_records[0]) % cache_line_size;
+                uint8_t* base = &m_aligned_records[0] + (misalignment ? cache_line_size - misalignment : 0);
+                std::copy(m_records.begin(), m_records.end(), base);
+                m_records_base = base;
+            }
+            assert(size_t(m_records_base) % cache_line_size == 0);
+        }
+
+        mapper::mappable_vector<uint8_t> m_records;
+        mapper::mappable_vector<uint8_t> m_label_tails;
+        packed_vector m_node_offsets;
+
+        // not mapped, see align_records()
+        std::vector<uint8_t> m_aligned_records;
+        const uint8_t* m_records_base;
+        const uint8_t* m_records_source;
+    };
+
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <boost/range.hpp>
+
+#include "succinct/bit_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Array of integers stored with a fixed number of bits each, the
+    // minimum needed for the largest value
+    struct packed_vector {
+
+        typedef uint64_t value_type;
+
+        packed_vector()
+            : m_size(0)
+            , m_width(1)
+        {}
+
+	template <typename Range>
+        packed_vector(Range const& ints)
+        {
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            uint64_t max_value = 0;
+            m_size = 0;
+            for (iterator_t iter = boost::begin(ints); iter != boost::end(ints); ++iter) {
+                max_value = std::max(max_value, uint64_t(*iter));
+                m_size += 1;
+            }
+
+            m_width = 1;
+            while (m_width < 64 && (max_value >> m_width)) ++m_width;
+
+            bit_vector_builder bvb;
+            bvb.reserve(m_size * m_width);
+            for (iterator_t iter = boost::begin(ints); iter != boost::end(ints); ++iter) {
+                bvb.append_bits(uint64_t(*iter), m_width);
+            }
+            bit_vector(&bvb).swap(m_bits);
+        }
+
+        value_type operator[](size_t i) const
+        {
+            assert(i < m_size);
+            return m_bits.get_bits(i * m_width, m_width);
+        }
+
+        void prefetch(size_t i) const
+        {
+            m_bits.data().prefetch(i * m_width / 64);
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        size_t width() const
+        {
+            return m_width;
+        }
+
+        void swap(packed_vector& other)
+        {
+            std::swap(m_size, other.m_size);
+            std::swap(m_width, other.m_width);
+            m_bits.swap(other.m_bits);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_size, "m_size")
+                (m_width, "m_width")
+                (m_bits, "m_bits")
+                ;
+        }
+
+    private:
+        uint64_t m_size;
+        uint64_t m_width;
+        bit_vector m_bits;
+    };
+
+}
+}
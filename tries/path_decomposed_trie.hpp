@@ -4,26 +4,99 @@
 #include <boost/make_shared.hpp>
 #include <boost/static_assert.hpp>
 
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "succinct/broadword.hpp"
 #include "succinct/bp_vector.hpp"
 #include "succinct/elias_fano.hpp"
 #include "succinct/forward_enumerator.hpp"
 
 #include "compacted_trie_builder.hpp"
+#include "child_directory.hpp"
+#include "optional_field.hpp"
 
 namespace succinct {
 namespace tries {
+
+    namespace detail {
+        // The labels store the symbols and, above them, the branching
+        // markers, so they need a wider type than the symbols
+        template <typename SymbolType>
+        struct symbol_traits;
+
+        template <>
+        struct symbol_traits<uint8_t>
+        {
+            typedef uint16_t label_char_type;
+            typedef std::string key_type;
+        };
+
+        template <>
+        struct symbol_traits<uint16_t>
+        {
+            typedef uint32_t label_char_type;
+            typedef std::vector<uint16_t> key_type;
+        };
+
+        template <>
+        struct symbol_traits<uint32_t>
+        {
+            typedef uint64_t label_char_type;
+            typedef std::vector<uint32_t> key_type;
+        };
+
+        // Whether the chars of the labels pool can hold the label
+        // chars of the symbols, branching markers included
+        template <typename LabelsPoolType, typename SymbolType>
+        struct labels_pool_fits
+        {
+            static const bool value = sizeof(typename LabelsPoolType::char_type)
+                >= sizeof(typename symbol_traits<SymbolType>::label_char_type);
+        };
+    }
  
-    // When Lexicographic is false, centroid path decomposition is used
-    template <typename LabelsPoolType, bool Lexicographic = false>
+    // When Lexicographic is false, centroid path decomposition is used.
+    // When FirstLabelChars is true, the first label char of each child
+    // is also stored next to its branching char, so that index() can
+    // reject a mismatching child (or confirm a key ending there)
+    // without accessing the labels pool.
+    //
+    // SymbolType is the alphabet of the keys: with uint16_t or uint32_t
+    // the keys are 0-terminated sequences of symbols (see
+    // stl_vector_adaptor), for example token ids, indexed without
+    // splitting them in bytes; operator[] returns a std::vector of
+    // symbols. The char type of the labels pool must be at least
+    // twice as wide as the symbols (see labels_pool_fits), so
+    // compressed_string_pool and fsst_string_pool only fit bytes.
+    // Only index(), index_from(), prefix_range() and operator[]
+    // support wide symbols, the other queries are on bytes and do not
+    // compile with wider symbols.
+    //
+    // When ChildDirectory is true, build_child_directory() can add a
+    // child_directory that index() uses to descend the large subtrees,
+    // and the directory is mapped with the trie. Otherwise the format
+    // is the same as without the directory
+    template <typename LabelsPoolType, bool Lexicographic = false, bool FirstLabelChars = false, typename SymbolType = uint8_t, bool ChildDirectory = false>
     struct path_decomposed_trie
     {
         typedef LabelsPoolType labels_pool_type;
-        typedef mapper::mappable_vector<uint8_t> branching_chars_type;
+        typedef SymbolType symbol_type;
+        typedef std::pair<const symbol_type*, const symbol_type*> symbol_range;
+        typedef typename detail::symbol_traits<SymbolType>::key_type key_type;
+        typedef typename detail::symbol_traits<SymbolType>::label_char_type label_char_type;
+        typedef mapper::mappable_vector<symbol_type> branching_chars_type;
+        typedef mapper::mappable_vector<label_char_type> first_label_chars_type;
+
+        BOOST_STATIC_ASSERT((detail::labels_pool_fits<LabelsPoolType, SymbolType>::value));
 
         path_decomposed_trie()
-	{
-            BOOST_STATIC_ASSERT(sizeof(typename labels_pool_type::char_type) >= sizeof(label_char_type));
-        }
+	{}
 
 	template <typename Range, typename Adaptor>
 	path_decomposed_trie(Range const& strings, Adaptor adaptor = stl_string_adaptor()) 
@@ -37,29 +110,289 @@ namespace tries {
 	    build(strings, stl_string_adaptor());
 	}
 
+        // Builds the trie choosing as heavy child the one with the
+        // largest total weight (ties broken by size) instead of the
+        // largest subtree, so that the keys that are queried most often
+        // are reached with fewer nodes. weights is a range of
+        // non-negative numbers, one for each string in the same order,
+        // for example the access counts from a query log. Ignored when
+        // Lexicographic is true
+	template <typename Range, typename Adaptor, typename Weights>
+	path_decomposed_trie(Range const& strings, Adaptor adaptor, Weights const& weights)
+	{
+            std::vector<double> w(boost::begin(weights), boost::end(weights));
+            if (w.size() != size_t(std::distance(boost::begin(strings), boost::end(strings)))) {
+                throw std::invalid_argument("The number of weights does not match the number of strings");
+            }
+	    build(strings, adaptor, &w);
+	}
+
 	template <typename T, typename Adaptor>
 	size_t index(T const& val, Adaptor adaptor) const
 	{
-	    char_range s = adaptor(val);
+            index_state state;
+            init_index_state(state, adaptor(val));
+            return run_index(state);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        // A point where a lookup can resume: the beginning of the node
+        // at node_pos, after cur_pos chars of the string are matched
+        struct entry_point
+        {
+            size_t node_pos;
+            size_t first_child_rank;
+            size_t cur_pos;
+            size_t dir; // child directory of the node, if any
+        };
+
+        // Finds the entry point of the deepest node that begins within
+        // the given prefix, so that the lookup of any string starting
+        // with the prefix can resume from there with index_from().
+        // Returns false if no key starts with the prefix
+	template <typename T, typename Adaptor>
+        bool prefix_entry_point(T const& prefix, entry_point& ep, Adaptor adaptor) const
+        {
+            if (!prefix_count(prefix, adaptor)) return false;
+
+	    symbol_range s = adaptor(prefix);
             size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1;
+            index_state state;
+            init_index_state(state, symbol_range(s.first, s.first + len));
+            while (true) {
+                ep.node_pos = state.cur_node_pos;
+                ep.first_child_rank = state.first_child_rank;
+                ep.cur_pos = state.cur_pos;
+                ep.dir = state.dir;
+
+                // the prefix is a key prefix, so the lookup ends
+                // either at a node beginning or inside its label
+                size_t ret;
+                if (index_enter_node(state, ret)) return true;
+                index_locate_label(state);
+                if (index_scan_node(state, ret)) return true;
+            }
+        }
+
+	template <typename T>
+        bool prefix_entry_point(T const& prefix, entry_point& ep) const
+        {
+            return prefix_entry_point(prefix, ep, stl_string_adaptor());
+        }
+
+        // Same as index(), resuming from an entry point of a prefix of
+        // the string
+	template <typename T, typename Adaptor>
+	size_t index_from(entry_point const& ep, T const& val, Adaptor adaptor) const
+	{
+            index_state state;
+            init_index_state(state, adaptor(val));
+            assert(ep.cur_pos <= state.len);
+            state.cur_node_pos = ep.node_pos;
+            state.first_child_rank = ep.first_child_rank;
+            state.cur_pos = ep.cur_pos;
+            state.dir = ep.dir;
+            return run_index(state);
+        }
+
+	template <typename T>
+	size_t index_from(entry_point const& ep, T const& val) const
+	{
+	    return index_from(ep, val, stl_string_adaptor());
+	}
+
+        // Looks up all the keys in the range, storing the results in
+        // ids. Up to in_flight lookups are interleaved, so that the
+        // memory accesses of each one are prefetched while the others
+        // make progress. The keys must stay alive for the whole call
+        // (for example, a std::vector of keys, not a lines stream)
+	template <typename Range, typename Adaptor>
+        void index_batch(Range const& keys, std::vector<size_t>& ids, Adaptor adaptor, size_t in_flight = 16) const
+        {
+            typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            iterator_t iter = boost::begin(keys);
+            iterator_t end = boost::end(keys);
+            ids.resize(std::distance(iter, end));
+            assert(in_flight > 0);
+
+            std::vector<index_state> states(in_flight);
+            std::vector<size_t> state_ids(in_flight);
+            std::vector<uint8_t> stages(in_flight, stage_done);
+            size_t next_id = 0;
+            size_t active = 0;
+
+            for (size_t i = 0; i < in_flight && iter != end; ++i, ++iter) {
+                init_index_state(states[i], adaptor(*iter));
+                state_ids[i] = next_id++;
+                stages[i] = stage_enter;
+                active += 1;
+            }
+
+            while (active) {
+                for (size_t i = 0; i < in_flight; ++i) {
+                    size_t ret;
+                    bool done;
+                    if (stages[i] == stage_enter) {
+                        done = index_enter_node(states[i], ret);
+                        stages[i] = stage_locate;
+                    } else if (stages[i] == stage_locate) {
+                        index_locate_label(states[i]);
+                        done = false;
+                        stages[i] = stage_scan;
+                    } else if (stages[i] == stage_scan) {
+                        done = index_scan_node(states[i], ret);
+                        stages[i] = stage_enter;
+                    } else {
+                        continue;
+                    }
+
+                    if (done) {
+                        ids[state_ids[i]] = ret;
+                        if (iter != end) {
+                            init_index_state(states[i], adaptor(*iter));
+                            ++iter;
+                            state_ids[i] = next_id++;
+                            stages[i] = stage_enter;
+                        } else {
+                            stages[i] = stage_done;
+                            active -= 1;
+                        }
+                    }
+                }
+            }
+        }
+
+	template <typename Range>
+        void index_batch(Range const& keys, std::vector<size_t>& ids) const
+        {
+            index_batch(keys, ids, stl_string_adaptor());
+        }
+
+        // Writes the key with the given id into buf, like snprintf: at
+        // most buf_len - 1 chars followed by a terminator, and returns
+        // the length of the whole key. The ancestors are collected
+        // first, so the labels are decoded forward straight into the
+        // buffer; no allocation is made unless the node is deeper than
+        // the fixed ancestor stack
+        size_t get_key(size_t idx, char* buf, size_t buf_len) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+            const size_t fixed_stack_size = 64;
+            ancestor fixed_stack[fixed_stack_size];
+            std::vector<ancestor> stack_fallback;
+            ancestor* stack = fixed_stack;
+            size_t depth = 0;
+
+            size_t rank0 = idx;
+            size_t cur_node_pos = idx ? m_bp.select0(idx - 1) : 0;
+	    size_t next_opener = cur_node_pos ? m_bp.find_open(cur_node_pos) : 0;
+
+            while (cur_node_pos) {
+                size_t opener_pos = next_opener;
+                rank0 = rank0 - (cur_node_pos - opener_pos + 1) / 2;
+                size_t parent_pos = rank0 ? m_bp.predecessor0(opener_pos) : 0;
+
+                m_branching_chars.prefetch(opener_pos - rank0 - 1);
+                cur_node_pos = parent_pos;
+		if (cur_node_pos) {
+		    next_opener = m_bp.find_open(cur_node_pos);
+		}
+
+                ancestor a;
+                a.rank0 = rank0;
+                a.child_idx = opener_pos - parent_pos - 1;
+                a.branching_char = m_branching_chars[opener_pos - rank0 - 1];
+                if (depth < fixed_stack_size) {
+                    stack[depth] = a;
+                } else {
+                    if (depth == fixed_stack_size) {
+                        stack_fallback.assign(fixed_stack, fixed_stack + fixed_stack_size);
+                    }
+                    stack_fallback.push_back(a);
+                    stack = &stack_fallback[0];
+                }
+                depth += 1;
+            }
+            assert(rank0 == 0);
+
+            size_t len = 0;
+            for (size_t i = depth; i != 0; --i) {
+                ancestor const& a = stack[i - 1];
+                typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(a.rank0);
+                size_t branching_chars_begin = 0;
+                while (true) {
+                    typename labels_pool_type::char_type c = label_enumerator.next();
+                    assert(c);
+                    if (c < branching_point) {
+                        put_char(buf, buf_len, len, char(c));
+                    } else {
+                        size_t branching_chars = c - branching_point + 1;
+                        if (a.child_idx < branching_chars_begin + branching_chars) break;
+                        branching_chars_begin += branching_chars;
+                    }
+                }
+                if (a.branching_char) {
+                    put_char(buf, buf_len, len, char(a.branching_char));
+                }
+            }
+
+	    // append the string tail
+            typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(idx);
+            while (true) {
+                typename labels_pool_type::char_type c = label_enumerator.next();
+                if (!c) break;
+                if (c < branching_point) {
+                    put_char(buf, buf_len, len, char(c));
+                }
+            }
+
+            if (buf_len) {
+                buf[std::min(len, buf_len - 1)] = 0;
+            }
+            return len;
+        }
+
+        // Returns the range [begin, end) of the ids of the keys that
+        // start with the given prefix, or an empty range if there are
+        // none. The ids are contiguous with both decompositions:
+        // the subtrees that branch off a centroid path below a given
+        // point come first in DFUDS order
+	template <typename T, typename Adaptor>
+        std::pair<size_t, size_t> prefix_range(T const& val, Adaptor adaptor) const
+        {
+	    symbol_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // the terminator is not part of the prefix
 
 	    size_t cur_pos = 0;
 	    size_t cur_node_pos = 1;
-
             size_t first_child_rank = 0;
+            // the subtree of the current node ends where the subtree of
+            // the child opened at this position begins (-1 for the root)
+            size_t subtree_end_open = -1;
 
             while (true) {
-                size_t rank0 = cur_node_pos - first_child_rank - 1; // == m_bp.rank0(node_end);
-                if (cur_pos == len) return rank0; // assume the string is null-terminated
-
+                size_t rank0 = cur_node_pos - first_child_rank - 1;
                 m_branching_chars.prefetch(first_child_rank);
                 typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(rank0);
-                
+
                 size_t branching_chars_begin = 0;
                 size_t branching_chars = 0;
                 size_t last_branching_point = -1;
                 while (true) {
-                    if (cur_pos == len) return -1;
+                    if (cur_pos == len) {
+                        // the children that branch at cur_pos or below share the prefix
+                        size_t first_child = branching_chars_begin;
+                        if (last_branching_point != cur_pos) first_child += branching_chars;
+                        size_t n_descendants = children_subtrees_size(cur_node_pos, first_child, subtree_end_open);
+                        return std::make_pair(rank0, rank0 + 1 + n_descendants);
+                    }
 
                     typename labels_pool_type::char_type label = label_enumerator.next();
                     if (label >= branching_point) {
@@ -67,52 +400,238 @@ namespace tries {
                         branching_chars = label - branching_point + 1;
                         last_branching_point = cur_pos;
                     } else {
-                        uint8_t c = s.first[cur_pos];
+                        // the prefix has no 0s, so it cannot match past the end of the label
+                        symbol_type c = s.first[cur_pos];
                         if (label != c) {
-                            if (last_branching_point != cur_pos) return -1;
+                            if (last_branching_point != cur_pos) return std::make_pair(size_t(0), size_t(0));
                             break;
                         }
                         cur_pos += 1;
+                    }
+                }
+
+                size_t found = find_branching_char(first_child_rank + branching_chars_begin, branching_chars, s.first[cur_pos]);
+                if (found == branching_chars) return std::make_pair(size_t(0), size_t(0));
+                cur_pos += 1;
+
+                size_t child = branching_chars_begin + found;
+                if (child) subtree_end_open = cur_node_pos + child - 1;
+                size_t child_open = cur_node_pos + child;
+                cur_node_pos = m_bp.find_close(child_open) + 1;
+                first_child_rank += child + (cur_node_pos - child_open) / 2;
+            }
+        }
+
+	template <typename T>
+        std::pair<size_t, size_t> prefix_range(T const& val) const
+        {
+            return prefix_range(val, stl_string_adaptor());
+        }
+
+        // Calls visitor(id, length) for each key that is a prefix of
+        // the len bytes at s, by increasing length, in a single
+        // descent. A key ends either at a 0 label char or at a 0
+        // branching char, which is the last of its group since the
+        // group chars are in decreasing order
+        template <typename Visitor>
+        void visit_prefixes(const uint8_t* s, size_t len, Visitor& visitor) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+	    size_t cur_pos = 0;
+	    size_t cur_node_pos = 1;
+            size_t first_child_rank = 0;
+
+            while (true) {
+                size_t rank0 = cur_node_pos - first_child_rank - 1;
+                m_branching_chars.prefetch(first_child_rank);
+                typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(rank0);
+
+                size_t branching_chars_begin = 0;
+                size_t branching_chars = 0;
+                size_t last_branching_point = -1;
+                while (true) {
+                    typename labels_pool_type::char_type label = label_enumerator.next();
+                    if (label >= branching_point) {
+                        branching_chars_begin += branching_chars;
+                        branching_chars = label - branching_point + 1;
+                        last_branching_point = cur_pos;
+
+                        size_t last_child = branching_chars_begin + branching_chars - 1;
+                        if (!m_branching_chars[first_child_rank + last_child]) {
+                            // the child is a leaf, its id is its rank0
+                            size_t child_open = cur_node_pos + last_child;
+                            size_t child_pos = m_bp.find_close(child_open) + 1;
+                            size_t child_first_child_rank = first_child_rank + last_child + (child_pos - child_open) / 2;
+                            visitor(child_pos - child_first_child_rank - 1, cur_pos);
+                        }
+                    } else if (!label) {
+                        // a group branching at this point can still
+                        // extend the key
+                        visitor(rank0, cur_pos);
+                        break;
+                    } else if (cur_pos < len && label == s[cur_pos]) {
+                        cur_pos += 1;
+                    } else {
+                        break;
+                    }
+                }
+
+                // keys have no 0s, so a 0 in s cannot extend a match
+                if (cur_pos == len || last_branching_point != cur_pos || !s[cur_pos]) return;
+
+                size_t found = find_branching_char(first_child_rank + branching_chars_begin, branching_chars, s[cur_pos]);
+                if (found == branching_chars) return;
+                cur_pos += 1;
+
+                size_t child = branching_chars_begin + found;
+                size_t child_open = cur_node_pos + child;
+                cur_node_pos = m_bp.find_close(child_open) + 1;
+                first_child_rank += child + (cur_node_pos - child_open) / 2;
+            }
+        }
+
+        // Returns the pair (id, length) of the longest key that is a
+        // prefix of the given string, or (-1, 0) if there is none
+	template <typename T, typename Adaptor>
+        std::pair<size_t, size_t> longest_prefix(T const& val, Adaptor adaptor) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // ignore the terminator
+
+            longest_prefix_visitor visitor;
+            visit_prefixes(s.first, len, visitor);
+            return visitor.m_result;
+        }
+
+	template <typename T>
+        std::pair<size_t, size_t> longest_prefix(T const& val) const
+        {
+            return longest_prefix(val, stl_string_adaptor());
+        }
+
+        // Returns the id of the first key not smaller than the given
+        // one, or size() if there is none; this is also the number of
+        // keys smaller than it. Only for the lexicographic trie, where
+        // ids follow the sorted order
+	template <typename T, typename Adaptor>
+        size_t lower_bound(T const& val, Adaptor adaptor) const
+        {
+            BOOST_STATIC_ASSERT(Lexicographic);
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+
+	    size_t cur_pos = 0;
+	    size_t cur_node_pos = 1;
+            size_t first_child_rank = 0;
+            size_t subtree_end_open = -1; // as in prefix_range
+
+            while (true) {
+                size_t rank0 = cur_node_pos - first_child_rank - 1;
+                m_branching_chars.prefetch(first_child_rank);
+                typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(rank0);
+
+                size_t branching_chars_begin = 0;
+                size_t branching_chars = 0;
+                size_t last_branching_point = -1;
+                typename labels_pool_type::char_type label;
+                while (true) {
+                    // the key is a prefix of the node key, and the
+                    // children branching above are larger than both
+                    if (cur_pos == len) return rank0;
+
+                    label = label_enumerator.next();
+                    if (label >= branching_point) {
+                        branching_chars_begin += branching_chars;
+                        branching_chars = label - branching_point + 1;
+                        last_branching_point = cur_pos;
+                    } else {
+                        if (label != s.first[cur_pos]) break;
+                        cur_pos += 1;
                         if (!label) {
                             if (cur_pos == len) return rank0;
-                            else return -1;
+                            // the node key is a proper prefix of the key
+                            return rank0 + 1;
                         }
                     }
                 }
-                    
+
+                // the label char is the smallest of the branching ones
+                // at this point, so a smaller char precedes the subtree
+                uint8_t c = s.first[cur_pos];
+                if (c < label) return rank0;
+
+                // the key follows the node key and the children that
+                // branch below this point; if a group branches here,
+                // also those with a smaller branching char (the group
+                // chars are in decreasing order)
+                size_t first_child = branching_chars_begin + branching_chars;
                 bool found_child = false;
-                
-                for (size_t i = branching_chars_begin; i < branching_chars_begin + branching_chars; ++i) {
-                    uint8_t c = m_branching_chars[first_child_rank + i];
-                    if (s.first[cur_pos] == c) {
-                        cur_pos += 1;
-                        found_child = true;
-
-                        size_t child = i;
-                        assert(child < m_bp.successor0(cur_node_pos) - cur_node_pos);
-                        size_t child_open = cur_node_pos + child;
-                        cur_node_pos = m_bp.find_close(child_open) + 1;
-                        assert((cur_node_pos - child_open) % 2 == 0);
-                        first_child_rank += child + (cur_node_pos - child_open) / 2;
-                        break;
+                if (last_branching_point == cur_pos) {
+                    for (size_t i = branching_chars_begin; i < branching_chars_begin + branching_chars; ++i) {
+                        uint8_t branching_char = m_branching_chars[first_child_rank + i];
+                        if (branching_char == c) {
+                            cur_pos += 1;
+                            found_child = true;
+
+                            size_t child = i;
+                            if (child) subtree_end_open = cur_node_pos + child - 1;
+                            size_t child_open = cur_node_pos + child;
+                            cur_node_pos = m_bp.find_close(child_open) + 1;
+                            first_child_rank += child + (cur_node_pos - child_open) / 2;
+                            break;
+                        } else if (branching_char < c) {
+                            first_child = i;
+                            break;
+                        }
                     }
                 }
-                
-                if (!found_child) return -1;
+
+                if (!found_child) {
+                    return rank0 + 1 + children_subtrees_size(cur_node_pos, first_child, subtree_end_open);
+                }
             }
-            assert(false);
-            return 0;
         }
 
 	template <typename T>
-	size_t index(T const& val) const
-	{
-	    return index(val, stl_string_adaptor());
-	}
+        size_t lower_bound(T const& val) const
+        {
+            return lower_bound(val, stl_string_adaptor());
+        }
 
-        std::string operator[](size_t idx) const
+        // Number of keys smaller than the given one, which need not be
+        // in the set (for the keys in the set it is equal to index())
+	template <typename T, typename Adaptor>
+        size_t rank(T const& val, Adaptor adaptor) const
         {
-            std::string ret;
+            return lower_bound(val, adaptor);
+        }
+
+	template <typename T>
+        size_t rank(T const& val) const
+        {
+            return lower_bound(val, stl_string_adaptor());
+        }
+
+        // Number of keys that start with the given prefix
+	template <typename T, typename Adaptor>
+        size_t prefix_count(T const& val, Adaptor adaptor) const
+        {
+            std::pair<size_t, size_t> range = prefix_range(val, adaptor);
+            return range.second - range.first;
+        }
+
+	template <typename T>
+        size_t prefix_count(T const& val) const
+        {
+            return prefix_count(val, stl_string_adaptor());
+        }
+
+        key_type operator[](size_t idx) const
+        {
+            key_type ret;
             ret.reserve(256); // reasonable tradeoff
 
             size_t rank0 = idx;
@@ -141,7 +660,7 @@ namespace tries {
 		    next_opener = m_bp.find_open(cur_node_pos);
 		}
 
-                uint8_t branching_char = m_branching_chars[opener_pos - rank0 - 1];
+                symbol_type branching_char = m_branching_chars[opener_pos - rank0 - 1];
 		if (branching_char) {
 		    ret.push_back(branching_char);
 		}
@@ -152,8 +671,8 @@ namespace tries {
                 while (true) {
                     typename labels_pool_type::char_type c = label_enumerator.next();
                     assert(c);
-                    if (c < 256) {
-                        ret.push_back((char)c);
+                    if (c < branching_point) {
+                        ret.push_back(typename key_type::value_type(c));
                     } else {
                         size_t branching_chars = c - branching_point + 1;
                         if (child_idx < branching_chars_begin + branching_chars) break;
@@ -172,8 +691,8 @@ namespace tries {
             while (true) {
                 typename labels_pool_type::char_type c = label_enumerator.next();
                 if (!c) break;
-                if (c < 256) {
-                    ret.push_back((char)c);
+                if (c < branching_point) {
+                    ret.push_back(typename key_type::value_type(c));
                 } else { 
                     // ignore branching points
                 }
@@ -182,15 +701,275 @@ namespace tries {
             return ret;
         }
         
+        // Enumerates the keys in id order, starting from a given id.
+        // The enumerator keeps the key of the current node decoded,
+        // together with the branching depths in its ancestors' labels,
+        // so that each step only decodes the label of the next node
+        // instead of walking back to the root
+        struct key_enumerator
+        {
+            key_enumerator()
+                : m_trie(0)
+            {}
+
+            // Returns the key of the next id, the reference is valid
+            // until the next call. Must be called at most size() - idx
+            // times
+            std::string const& next()
+            {
+                BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+                assert(m_trie);
+                if (m_node_end != size_t(-1)) {
+                    advance();
+                }
+
+                // decode the label of the current node, remembering
+                // where its children branch
+                size_t groups_begin = m_groups.size();
+                size_t first_child_rank = m_node_pos - m_idx - 1;
+                m_trie->m_branching_chars.prefetch(first_child_rank);
+                typename labels_pool_type::string_enumerator label_enumerator =
+                    m_trie->m_labels.get_string_enumerator(m_idx);
+                size_t branching_chars = 0;
+                while (true) {
+                    typename labels_pool_type::char_type c = label_enumerator.next();
+                    if (!c) break;
+                    if (c < branching_point) {
+                        m_key.push_back((char)c);
+                    } else {
+                        m_groups.push_back(branching_group(branching_chars, m_key.size()));
+                        branching_chars += c - branching_point + 1;
+                    }
+                }
+
+                m_node_end = m_trie->m_bp.successor0(m_node_pos);
+                assert(m_node_end - m_node_pos == branching_chars);
+                if (branching_chars) {
+                    m_stack.push_back(frame(first_child_rank, branching_chars, groups_begin, m_groups.size()));
+                }
+
+                return m_key;
+            }
+
+            friend struct path_decomposed_trie;
+        private:
+
+            struct branching_group
+            {
+                branching_group(size_t first_child_, size_t depth_)
+                    : first_child(first_child_)
+                    , depth(depth_)
+                {}
+
+                size_t first_child;
+                size_t depth; // key length at the branching point
+            };
+
+            struct frame
+            {
+                frame(size_t first_child_rank_, size_t remaining_, size_t groups_begin_, size_t groups_end_)
+                    : first_child_rank(first_child_rank_)
+                    , remaining(remaining_)
+                    , groups_begin(groups_begin_)
+                    , groups_end(groups_end_)
+                {}
+
+                size_t first_child_rank;
+                size_t remaining; // children still to visit, the next one is remaining - 1
+                size_t groups_begin;
+                size_t groups_end; // one past the group of the next child
+            };
+
+            key_enumerator(path_decomposed_trie const* trie, size_t idx)
+                : m_trie(trie)
+                , m_idx(idx)
+                , m_node_end(-1)
+            {
+                BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+                assert(idx < m_trie->size());
+                bp_vector const& bp = m_trie->m_bp;
+                m_key.reserve(256);
+
+                // collect the ancestors as (node position, rank0, child index)
+                std::vector<std::pair<size_t, std::pair<size_t, size_t> > > ancestors;
+                size_t rank0 = idx;
+                size_t node_pos = idx ? bp.select0(idx - 1) + 1 : 1;
+                m_node_pos = node_pos;
+                while (rank0) {
+                    size_t close_pos = node_pos - 1;
+                    size_t opener_pos = bp.find_open(close_pos);
+                    rank0 = rank0 - (close_pos - opener_pos + 1) / 2;
+                    size_t parent_pos = rank0 ? bp.predecessor0(opener_pos) + 1 : 1;
+                    ancestors.push_back(std::make_pair(parent_pos, std::make_pair(rank0, opener_pos - parent_pos)));
+                    node_pos = parent_pos;
+                }
+
+                // decode the ancestors' labels up to the branching
+                // point of the path to idx
+                for (size_t i = ancestors.size(); i-- > 0; ) {
+                    size_t parent_pos = ancestors[i].first;
+                    size_t parent_rank0 = ancestors[i].second.first;
+                    size_t child_idx = ancestors[i].second.second;
+                    size_t first_child_rank = parent_pos - parent_rank0 - 1;
+
+                    size_t groups_begin = m_groups.size();
+                    typename labels_pool_type::string_enumerator label_enumerator =
+                        m_trie->m_labels.get_string_enumerator(parent_rank0);
+                    size_t branching_chars = 0;
+                    while (true) {
+                        typename labels_pool_type::char_type c = label_enumerator.next();
+                        assert(c);
+                        if (c < branching_point) {
+                            m_key.push_back((char)c);
+                        } else {
+                            m_groups.push_back(branching_group(branching_chars, m_key.size()));
+                            branching_chars += c - branching_point + 1;
+                            if (child_idx < branching_chars) break;
+                        }
+                    }
+
+                    m_stack.push_back(frame(first_child_rank, child_idx, groups_begin, m_groups.size()));
+                    uint8_t branching_char = m_trie->m_branching_chars[first_child_rank + child_idx];
+                    if (branching_char) {
+                        m_key.push_back(branching_char);
+                    }
+                }
+            }
+
+            // moves to the node following the current one in DFUDS
+            // order, leaving in m_key the key prefix up to its label
+            void advance()
+            {
+                while (m_stack.back().remaining == 0) {
+                    m_groups.erase(m_groups.begin() + m_stack.back().groups_begin, m_groups.end());
+                    m_stack.pop_back();
+                    assert(!m_stack.empty()); // enumerated past the end
+                }
+
+                frame& f = m_stack.back();
+                size_t child = --f.remaining;
+                while (m_groups[f.groups_end - 1].first_child > child) {
+                    f.groups_end -= 1;
+                }
+                assert(f.groups_end > f.groups_begin);
+                m_key.resize(m_groups[f.groups_end - 1].depth);
+                uint8_t branching_char = m_trie->m_branching_chars[f.first_child_rank + child];
+                if (branching_char) {
+                    m_key.push_back(branching_char);
+                }
+
+                m_idx += 1;
+                m_node_pos = m_node_end + 1;
+            }
+
+            path_decomposed_trie const* m_trie;
+            size_t m_idx;
+            size_t m_node_pos;
+            size_t m_node_end; // -1 until the first key is decoded
+            std::vector<frame> m_stack;
+            std::vector<branching_group> m_groups;
+            std::string m_key;
+        };
+
+        key_enumerator get_key_enumerator(size_t idx = 0) const
+        {
+            return key_enumerator(this, idx);
+        }
+
+        // Appends to results the pairs (id, distance) of the keys
+        // within Levenshtein distance max_dist from the given one, in
+        // no particular order. The trie is visited carrying the edit
+        // distance matrix row of each prefix, and a subtree is pruned
+        // as soon as all the row exceeds max_dist
+	template <typename T, typename Adaptor>
+        void fuzzy_search(T const& val, size_t max_dist,
+                          std::vector<std::pair<size_t, size_t> >& results,
+                          Adaptor adaptor) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // ignore the terminator
+
+            levenshtein_walker walker(s.first, len, max_dist, results);
+            walk(walker);
+        }
+
+	template <typename T>
+        void fuzzy_search(T const& val, size_t max_dist,
+                          std::vector<std::pair<size_t, size_t> >& results) const
+        {
+            fuzzy_search(val, max_dist, results, stl_string_adaptor());
+        }
+
+        // Writes to out the ids of the keys accepted by the automaton
+        // (see dfa.hpp for the interface), in no particular order. A
+        // subtree is pruned as soon as the automaton reaches a dead
+        // state, so selective patterns only visit a small part of the
+        // trie
+        template <typename Automaton, typename OutputIterator>
+        OutputIterator match(Automaton const& automaton, OutputIterator out) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+            automaton_walker<Automaton, OutputIterator> walker(automaton, out);
+            walk(walker);
+            return walker.out();
+        }
+
         size_t size() const
         {
             return m_bp.size() / 2;
         }
 
+        // Replays the queries (for example a sample of a query log) and
+        // moves to the hot tier of the labels pool the labels of the
+        // most visited nodes, at most hot_fraction of all the nodes.
+        // The ids do not change. Requires a two_tier_string_pool (or a
+        // pool with the same place() method) as labels pool
+	template <typename Range, typename Adaptor>
+        void optimize_label_placement(Range const& queries, Adaptor adaptor, double hot_fraction)
+        {
+            std::vector<size_t> visits(size());
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            for (iterator_t iter = boost::begin(queries); iter != boost::end(queries); ++iter) {
+                index_state state;
+                init_index_state(state, adaptor(*iter));
+                size_t ret;
+                while (true) {
+                    size_t rank0 = state.cur_node_pos - state.first_child_rank - 1;
+                    if (index_enter_node(state, ret)) break;
+                    index_locate_label(state);
+                    visits[rank0] += 1; // the label is read
+                    if (index_scan_node(state, ret)) break;
+                }
+            }
+
+            std::vector<std::pair<size_t, size_t> > by_visits; // (visits, rank0)
+            for (size_t rank0 = 0; rank0 < visits.size(); ++rank0) {
+                if (visits[rank0]) by_visits.push_back(std::make_pair(visits[rank0], rank0));
+            }
+            std::sort(by_visits.begin(), by_visits.end(), std::greater<std::pair<size_t, size_t> >());
+
+            size_t n_hot = std::min(by_visits.size(), size_t(hot_fraction * size()));
+            std::vector<bool> hot(size());
+            for (size_t i = 0; i < n_hot; ++i) {
+                hot[by_visits[i].second] = true;
+            }
+            m_labels.place(hot);
+        }
+
+	template <typename Range>
+        void optimize_label_placement(Range const& queries, double hot_fraction)
+        {
+            optimize_label_placement(queries, stl_string_adaptor(), hot_fraction);
+        }
+
 	void swap(path_decomposed_trie& other)
         {
 	    m_bp.swap(other.m_bp);
 	    m_branching_chars.swap(other.m_branching_chars);
+            m_first_label_chars.swap(other.m_first_label_chars);
+            m_child_directory.swap(other.m_child_directory);
             m_labels.swap(other.m_labels);
 	}
 
@@ -199,6 +978,10 @@ namespace tries {
             visit
                 (m_bp, "m_bp")
                 (m_branching_chars, "m_branching_chars")
+		;
+            optional_field<FirstLabelChars>::map(visit, m_first_label_chars, "m_first_label_chars");
+            optional_field<ChildDirectory>::map(visit, m_child_directory, "m_child_directory");
+            visit
                 (m_labels, "m_labels")
 		;
         }
@@ -212,6 +995,27 @@ namespace tries {
         {
             return m_branching_chars;
         }
+
+        first_label_chars_type const& get_first_label_chars() const
+        {
+            return m_first_label_chars;
+        }
+
+        // Builds the directory of the children positions of the nodes
+        // with at least min_subtree_size nodes below them, which
+        // index() uses instead of find_close. The directory is empty
+        // unless built; it is mapped with the trie. Only when
+        // ChildDirectory is true
+        void build_child_directory(size_t min_subtree_size)
+        {
+            BOOST_STATIC_ASSERT(ChildDirectory);
+            child_directory(m_bp, min_subtree_size).swap(m_child_directory);
+        }
+
+        child_directory const& get_child_directory() const
+        {
+            return m_child_directory;
+        }
         
         labels_pool_type const& get_labels() const
         {
@@ -220,21 +1024,408 @@ namespace tries {
         
     private:
 
-        typedef uint16_t label_char_type;
-        static const size_t branching_point = 256;
+        static const uint64_t branching_point = uint64_t(1) << (8 * sizeof(symbol_type));
+
+        // Depth-first visit of the keys, driven by a Walker that keeps
+        // a state for each prefix length and provides
+        //   bool step(size_t depth, uint8_t c): computes the state at
+        //     depth + 1 after reading c, false if no key below can be
+        //     accepted (the subtree is pruned)
+        //   void accept(size_t depth, size_t idx): called for each
+        //     reached key, of length depth
+        // The children of a node are visited when their branching
+        // group is found in the label, so the states of the prefixes
+        // up to the branching point are still valid
+        template <typename Walker>
+        void walk(Walker& walker) const
+        {
+            walk_node(walker, 1, 0, 0);
+        }
+
+        template <typename Walker>
+        void walk_node(Walker& walker, size_t node_pos, size_t first_child_rank, size_t depth) const
+        {
+            BOOST_STATIC_ASSERT(sizeof(symbol_type) == 1); // byte keys only
+            size_t rank0 = node_pos - first_child_rank - 1;
+            m_branching_chars.prefetch(first_child_rank);
+            typename labels_pool_type::string_enumerator label_enumerator = m_labels.get_string_enumerator(rank0);
+
+            size_t branching_chars = 0;
+            while (true) {
+                typename labels_pool_type::char_type label = label_enumerator.next();
+                if (label >= branching_point) {
+                    size_t group_begin = branching_chars;
+                    branching_chars += label - branching_point + 1;
+                    for (size_t i = group_begin; i < branching_chars; ++i) {
+                        uint8_t c = m_branching_chars[first_child_rank + i];
+                        size_t child_depth = depth;
+                        if (c) { // a 0 branching char ends the key
+                            if (!walker.step(depth, c)) continue;
+                            child_depth += 1;
+                        }
+                        size_t child_open = node_pos + i;
+                        size_t child_pos = m_bp.find_close(child_open) + 1;
+                        walk_node(walker, child_pos,
+                                  first_child_rank + i + (child_pos - child_open) / 2,
+                                  child_depth);
+                    }
+                } else if (!label) {
+                    walker.accept(depth, rank0);
+                    return;
+                } else {
+                    if (!walker.step(depth, uint8_t(label))) return;
+                    depth += 1;
+                }
+            }
+        }
+
+        struct levenshtein_walker
+        {
+            levenshtein_walker(const uint8_t* s, size_t len, size_t max_dist,
+                               std::vector<std::pair<size_t, size_t> >& results)
+                : m_s(s)
+                , m_len(len)
+                , m_max_dist(max_dist)
+                , m_rows(len + 1)
+                , m_results(results)
+            {
+                for (size_t j = 0; j <= len; ++j) {
+                    m_rows[j] = j;
+                }
+            }
+
+            bool step(size_t depth, uint8_t c)
+            {
+                size_t row_size = m_len + 1;
+                if (m_rows.size() < (depth + 2) * row_size) {
+                    m_rows.resize((depth + 2) * row_size);
+                }
+                const size_t* prev = &m_rows[depth * row_size];
+                size_t* cur = &m_rows[(depth + 1) * row_size];
+
+                cur[0] = depth + 1;
+                size_t row_min = cur[0];
+                for (size_t j = 1; j <= m_len; ++j) {
+                    size_t subst = prev[j - 1] + (m_s[j - 1] != c);
+                    cur[j] = std::min(std::min(prev[j], cur[j - 1]) + 1, subst);
+                    row_min = std::min(row_min, cur[j]);
+                }
+                return row_min <= m_max_dist;
+            }
+
+            void accept(size_t depth, size_t idx)
+            {
+                size_t dist = m_rows[depth * (m_len + 1) + m_len];
+                if (dist <= m_max_dist) {
+                    m_results.push_back(std::make_pair(idx, dist));
+                }
+            }
+
+        private:
+            const uint8_t* m_s;
+            size_t m_len;
+            size_t m_max_dist;
+            std::vector<size_t> m_rows; // one row of m_len + 1 entries per depth
+            std::vector<std::pair<size_t, size_t> >& m_results;
+        };
+
+        // Groups up to this degree are scanned linearly, larger ones
+        // up to simd_search_max_degree are compared 16 chars at a time
+        static const size_t linear_search_max_degree = 8;
+        static const size_t simd_search_max_degree = 64;
+
+        // Returns the position of c in the branching group of n_chars
+        // chars starting at m_branching_chars[begin], or n_chars if c
+        // is not there. The position is also the child index in the
+        // group, as the DFUDS order follows the group order. The chars
+        // of a group are in decreasing order, so the high-fanout
+        // nodes near the root are binary searched
+        size_t find_branching_char(size_t begin, size_t n_chars, symbol_type c) const
+        {
+            const symbol_type* chars = m_branching_chars.begin() + begin;
+            if (n_chars <= linear_search_max_degree) {
+                for (size_t i = 0; i < n_chars; ++i) {
+                    if (chars[i] <= c) return chars[i] == c ? i : n_chars;
+                }
+                return n_chars;
+            }
+
+#if defined(__SSE2__)
+            if (sizeof(symbol_type) == 1 && n_chars <= simd_search_max_degree) {
+                __m128i needle = _mm_set1_epi8(char(c));
+                size_t i = 0;
+                for (; i + 16 <= n_chars; i += 16) {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+                    uint64_t mask = uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                    if (mask) return i + broadword::lsb(mask);
+                }
+                // do not read past the end of the group, which may be
+                // the end of the mapping
+                for (; i < n_chars; ++i) {
+                    if (chars[i] == c) return i;
+                }
+                return n_chars;
+            }
+#endif
+
+            const symbol_type* found = std::lower_bound(chars, chars + n_chars, c, std::greater<symbol_type>());
+            return (found != chars + n_chars && *found == c) ? size_t(found - chars) : n_chars;
+        }
+
+        struct ancestor
+        {
+            size_t rank0;
+            size_t child_idx;
+            uint8_t branching_char;
+        };
+
+        static void put_char(char* buf, size_t buf_len, size_t& len, char c)
+        {
+            if (len + 1 < buf_len) buf[len] = c;
+            len += 1;
+        }
+
+        struct longest_prefix_visitor
+        {
+            longest_prefix_visitor()
+                : m_result(size_t(-1), 0)
+            {}
+
+            void operator()(size_t idx, size_t length)
+            {
+                m_result = std::make_pair(idx, length);
+            }
+
+            std::pair<size_t, size_t> m_result;
+        };
+
+        template <typename Automaton, typename OutputIterator>
+        struct automaton_walker
+        {
+            automaton_walker(Automaton const& automaton, OutputIterator out)
+                : m_automaton(automaton)
+                , m_states(1, automaton.initial_state())
+                , m_out(out)
+            {}
+
+            bool step(size_t depth, uint8_t c)
+            {
+                if (m_states.size() < depth + 2) {
+                    m_states.resize(depth + 2);
+                }
+                m_states[depth + 1] = m_automaton.next(m_states[depth], c);
+                return !m_automaton.is_dead(m_states[depth + 1]);
+            }
+
+            void accept(size_t depth, size_t idx)
+            {
+                if (m_automaton.is_final(m_states[depth])) {
+                    *m_out++ = idx;
+                }
+            }
+
+            OutputIterator out() const
+            {
+                return m_out;
+            }
+
+        private:
+            Automaton const& m_automaton;
+            std::vector<typename Automaton::state_type> m_states; // state after each prefix
+            OutputIterator m_out;
+        };
+
+        // Number of nodes in the subtrees of the children of the node
+        // at node_pos, from first_child to the last one (in DFUDS
+        // order these are the subtrees that come first). If
+        // first_child is 0, the end of the node subtree is given by
+        // subtree_end_open, as in prefix_range
+        size_t children_subtrees_size(size_t node_pos, size_t first_child, size_t subtree_end_open) const
+        {
+            size_t node_end = m_bp.successor0(node_pos);
+            size_t deg = node_end - node_pos;
+            assert(first_child <= deg);
+            if (first_child == deg) return 0;
+
+            size_t end;
+            if (first_child) {
+                end = m_bp.find_close(node_pos + first_child - 1) + 1;
+            } else if (subtree_end_open != size_t(-1)) {
+                end = m_bp.find_close(subtree_end_open) + 1;
+            } else {
+                end = m_bp.size();
+            }
+            // each of the (deg - first_child) subtrees of size n takes 2n - 1 bits
+            assert((end - node_end - 1 + deg - first_child) % 2 == 0);
+            return (end - node_end - 1 + deg - first_child) / 2;
+        }
+
+        // State of a lookup between two steps; the traversal is at the
+        // beginning of the node at cur_node_pos, and cur_pos characters
+        // of s have been matched
+        struct index_state
+        {
+            const symbol_type* s;
+            size_t len;
+            size_t cur_pos;
+            size_t cur_node_pos;
+            size_t first_child_rank;
+            size_t dir; // child directory of the current node, 0 if none
+            typename labels_pool_type::string_enumerator label_enumerator;
+        };
+
+        enum index_stage {
+            stage_enter,
+            stage_locate,
+            stage_scan,
+            stage_done
+        };
+
+        void init_index_state(index_state& state, symbol_range s) const
+        {
+            state.s = s.first;
+            state.len = boost::size(s);
+            state.cur_pos = 0;
+            state.cur_node_pos = 1;
+            state.first_child_rank = 0;
+            state.dir = ChildDirectory ? m_child_directory.root() : 0;
+        }
+
+        size_t run_index(index_state& state) const
+        {
+            size_t ret;
+            while (true) {
+                if (index_enter_node(state, ret)) return ret;
+                index_locate_label(state);
+                if (index_scan_node(state, ret)) return ret;
+            }
+            assert(false);
+            return 0;
+        }
+
+        // The steps below are split so that the memory accesses
+        // started by each one can be overlapped with other lookups
+        // before the next one: the first prefetches the branching
+        // chars, the second locates the label in the pool (a select,
+        // which then prefetches the label bytes) and the third reads
+        // them. The elias_fano of the pool has no prefetch, so the
+        // select is a demand load, which overlaps with the steps of
+        // the other lookups only as far as the out-of-order core
+        // allows. The first and the last step return true when the
+        // lookup is complete, with the result in ret
+        bool index_enter_node(index_state& state, size_t& ret) const
+        {
+            size_t rank0 = state.cur_node_pos - state.first_child_rank - 1; // == m_bp.rank0(node_end);
+            if (state.cur_pos == state.len) { // assume the string is null-terminated
+                ret = rank0;
+                return true;
+            }
+
+            m_branching_chars.prefetch(state.first_child_rank);
+            return false;
+        }
+
+        void index_locate_label(index_state& state) const
+        {
+            size_t rank0 = state.cur_node_pos - state.first_child_rank - 1;
+            state.label_enumerator = m_labels.get_string_enumerator(rank0);
+        }
+
+        bool index_scan_node(index_state& state, size_t& ret) const
+        {
+            const symbol_type* s = state.s;
+            size_t len = state.len;
+            size_t cur_pos = state.cur_pos;
+            size_t cur_node_pos = state.cur_node_pos;
+            size_t first_child_rank = state.first_child_rank;
+            typename labels_pool_type::string_enumerator& label_enumerator = state.label_enumerator;
+            ret = -1;
+
+            size_t branching_chars_begin = 0;
+            size_t branching_chars = 0;
+            size_t last_branching_point = -1;
+            while (true) {
+                // skip in bulk the run of label chars equal to the
+                // string, up to the first branching marker or mismatch
+                cur_pos += label_enumerator.match(s + cur_pos, len - cur_pos);
+                if (cur_pos == len) return true;
+
+                typename labels_pool_type::char_type label = label_enumerator.next();
+                if (label >= branching_point) {
+                    branching_chars_begin += branching_chars;
+                    branching_chars = label - branching_point + 1;
+                    last_branching_point = cur_pos;
+                } else {
+                    symbol_type c = s[cur_pos];
+                    if (label != c) {
+                        if (last_branching_point != cur_pos) return true;
+                        break;
+                    }
+                    cur_pos += 1;
+                    if (!label) {
+                        if (cur_pos == len) ret = cur_node_pos - first_child_rank - 1;
+                        return true;
+                    }
+                }
+            }
+
+            symbol_type c = s[cur_pos];
+            size_t found = find_branching_char(first_child_rank + branching_chars_begin, branching_chars, c);
+            if (found == branching_chars) return true;
+
+            size_t child = branching_chars_begin + found;
+            assert(child < m_bp.successor0(cur_node_pos) - cur_node_pos);
+
+            // a branching point at the beginning of the label
+            // does not allow an early decision
+            label_char_type first_label_char = branching_point;
+            if (FirstLabelChars && c && cur_pos + 1 < len) {
+                first_label_char = m_first_label_chars[first_child_rank + child];
+                if (first_label_char < branching_point && first_label_char != s[cur_pos + 1]) {
+                    return true;
+                }
+            }
+
+            size_t child_open = cur_node_pos + child;
+            if (ChildDirectory && state.dir) {
+                state.cur_node_pos = m_child_directory.child_pos(state.dir, child);
+                state.dir = m_child_directory.child_dir(state.dir, child);
+            } else {
+                state.cur_node_pos = m_bp.find_close(child_open) + 1;
+            }
+            assert((state.cur_node_pos - child_open) % 2 == 0);
+            state.first_child_rank = first_child_rank + child + (state.cur_node_pos - child_open) / 2;
+            state.cur_pos = cur_pos + 1;
+
+            if (first_label_char == 0 && cur_pos + 2 == len) {
+                // the child key is the string
+                ret = state.cur_node_pos - state.first_child_rank - 1;
+                return true;
+            }
+            // the next find_close will start from the child node
+            m_bp.data().prefetch(state.cur_node_pos / 64);
+            return false;
+        }
         
 	struct centroid_builder_visitor
 	{
-	    centroid_builder_visitor()
+	    centroid_builder_visitor(std::vector<double> const* weights = 0)
+                : m_weights(weights)
+                , m_n_leaves(0)
 	    {}
 
 	    struct subtree {
+                subtree()
+                    : m_weight(0)
+                {}
+
 		std::vector<label_char_type> m_centroid_path_string;
-                std::vector<uint8_t> m_centroid_path_branches;
+                std::vector<symbol_type> m_centroid_path_branches;
 
 		bit_vector_builder m_bp;
-                std::vector<uint8_t> m_branching_chars;
+                std::vector<symbol_type> m_branching_chars;
 		std::vector<label_char_type> m_labels;
+                double m_weight; // total weight of the keys, if weighted
 
 		size_t size() const
 		{
@@ -266,9 +1457,9 @@ namespace tries {
 	    };
 
 	    typedef boost::shared_ptr<subtree> representation_type;
-            typedef std::vector<std::pair<uint8_t, representation_type> > children_type;
+            typedef std::vector<std::pair<symbol_type, representation_type> > children_type;
 
-            representation_type node(children_type& children, const uint8_t* buf, size_t offset, size_t skip) 
+            representation_type node(children_type& children, const symbol_type* buf, size_t offset, size_t skip) 
 	    {
 		representation_type ret;
 
@@ -279,18 +1470,20 @@ namespace tries {
                     if (Lexicographic) {
                         largest_child = 0;
                     } else {
-                        size_t largest_child_size = 0;
-                    
                         for (size_t i = 0; i < children.size(); ++i) {
-                            if (i == 0 || children[i].second->size() > largest_child_size) {
+                            if (i == 0 || heavier(*children[i].second, *children[largest_child].second)) {
                                 largest_child = i;
-                                largest_child_size = children[i].second->size();
                             }
                         }
                     }
                     assert(largest_child != -1);
 
                     children[largest_child].second.swap(ret);
+                    for (size_t i = 0; i < children.size(); ++i) {
+                        if (i != largest_child) {
+                            ret->m_weight += children[i].second->m_weight;
+                        }
+                    }
                     size_t n_branches = children.size() - 1;
                     assert(n_branches > 0);
                     assert(n_branches <= std::numeric_limits<label_char_type>::max());
@@ -305,7 +1498,11 @@ namespace tries {
                         }
                     }
                 } else {
+                    // leaves are closed in the order of the strings
                     ret = boost::make_shared<subtree>();
+                    if (m_weights) {
+                        ret->m_weight = (*m_weights)[m_n_leaves++];
+                    }
                 }
 
                 // append in reverse order
@@ -334,15 +1531,25 @@ namespace tries {
 	    }
 
 	private:
+            bool heavier(subtree const& a, subtree const& b) const
+            {
+                if (m_weights && a.m_weight != b.m_weight) {
+                    return a.m_weight > b.m_weight;
+                }
+                return a.size() > b.size();
+            }
+
 	    representation_type m_root_node;
+            std::vector<double> const* m_weights;
+            size_t m_n_leaves;
 	};
 
 
 	template <typename Range, typename Adaptor>
-	void build(Range const& strings, Adaptor adaptor) 
+	void build(Range const& strings, Adaptor adaptor, std::vector<double> const* weights = 0)
 	{
-	    centroid_builder_visitor visitor;
-	    succinct::tries::compacted_trie_builder<centroid_builder_visitor> builder;
+	    centroid_builder_visitor visitor(weights);
+	    succinct::tries::compacted_trie_builder<centroid_builder_visitor, symbol_type> builder;
 	    builder.build(visitor, strings, adaptor);
 	    typename centroid_builder_visitor::representation_type root = visitor.get_root();
 	    
@@ -350,10 +1557,29 @@ namespace tries {
             branching_chars_type(root->m_branching_chars).swap(m_branching_chars);
             labels_pool_type(root->m_labels).swap(m_labels);
             assert(m_labels.size() == m_bp.size() / 2);
+
+            if (FirstLabelChars) {
+                build_first_label_chars();
+            }
 	}
 
+        void build_first_label_chars()
+        {
+            // each node but the root is a child; its branching char is
+            // at the rank of its opening parenthesis, minus the fake root
+            std::vector<label_char_type> first_label_chars(m_branching_chars.size());
+            for (size_t rank0 = 1; rank0 < size(); ++rank0) {
+                size_t opener_pos = m_bp.find_open(m_bp.select0(rank0 - 1));
+                size_t child = m_bp.rank(opener_pos) - 1;
+                first_label_chars[child] = m_labels.get_string_enumerator(rank0).next();
+            }
+            first_label_chars_type(first_label_chars).swap(m_first_label_chars);
+        }
+
 	bp_vector m_bp;
         branching_chars_type m_branching_chars;
+        first_label_chars_type m_first_label_chars; // empty unless FirstLabelChars
+        child_directory m_child_directory; // empty unless ChildDirectory and built
         
         labels_pool_type m_labels;
         
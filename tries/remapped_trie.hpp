@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/range.hpp>
+#include <boost/static_assert.hpp>
+
+#include "bit_strings.hpp"
+#include "alphabet_map.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Trie over the keys remapped to the dense alphabet of the bytes
+    // they use (see alphabet_map), computed at build time and mapped
+    // and frozen with the trie; index() remaps the string on the fly,
+    // and rejects it if it has a byte outside the alphabet.
+    //
+    // With BitPacked false each code takes a byte, which is what the
+    // byte tries (path_decomposed_trie) need, as they cannot have 0s
+    // inside the keys; the codes are small, so the labels take a
+    // single vbyte byte. With BitPacked true the codes are packed in
+    // ceil(log2(sigma + 1)) bits, which makes the keys and the skips
+    // of the binary tries (hollow_trie, centroid_hollow_trie) shorter.
+    // The ids are the same as the ones of Trie on the original keys
+    template <typename Trie, bool BitPacked = false>
+    struct remapped_trie
+    {
+        typedef Trie trie_type;
+
+        remapped_trie()
+        {}
+
+	template <typename Range, typename Adaptor>
+        remapped_trie(Range const& strings, Adaptor adaptor)
+        {
+            build(strings, adaptor);
+        }
+
+	template <typename Range>
+        remapped_trie(Range const& strings)
+        {
+            build(strings, stl_string_adaptor());
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1;
+
+            uint8_t stack_buf[256];
+            std::vector<uint8_t> heap_buf;
+            uint8_t* buf = stack_buf;
+            if (len + 1 > sizeof(stack_buf)) {
+                heap_buf.resize(len + 1);
+                buf = &heap_buf[0];
+            }
+
+            size_t encoded_len = m_alphabet.encode(s.first, len, buf, BitPacked);
+            if (encoded_len == size_t(-1)) return size_t(-1);
+            return m_trie.index(char_range(buf, buf + encoded_len), range_adaptor());
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+	    return index(val, stl_string_adaptor());
+	}
+
+        std::string operator[](size_t idx) const
+        {
+            BOOST_STATIC_ASSERT(!BitPacked);
+            return m_alphabet.decode(m_trie[idx]);
+        }
+
+        size_t size() const
+        {
+            return m_trie.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+        alphabet_map const& get_alphabet() const
+        {
+            return m_alphabet;
+        }
+
+	void swap(remapped_trie& other)
+        {
+            m_alphabet.swap(other.m_alphabet);
+            m_trie.swap(other.m_trie);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_alphabet, "m_alphabet")
+                (m_trie, "m_trie")
+		;
+        }
+
+    private:
+
+        struct range_adaptor
+        {
+            char_range operator()(char_range s) const
+            {
+                return s;
+            }
+        };
+
+        // Encodes the keys for the builders, which copy each string
+        // before asking for the next one
+        template <typename Adaptor>
+        struct encoding_adaptor
+        {
+            encoding_adaptor(alphabet_map const& alphabet, Adaptor adaptor)
+                : m_alphabet(&alphabet)
+                , m_adaptor(adaptor)
+            {}
+
+            template <typename T>
+            char_range operator()(T const& val) const
+            {
+                char_range s = m_adaptor(val);
+                size_t len = boost::size(s);
+                if (len && !s.first[len - 1]) len -= 1;
+                m_buf.resize(len + 1);
+                size_t encoded_len = m_alphabet->encode(s.first, len, &m_buf[0], BitPacked);
+                assert(encoded_len != size_t(-1));
+                return char_range(&m_buf[0], &m_buf[0] + encoded_len);
+            }
+
+        private:
+            alphabet_map const* m_alphabet;
+            Adaptor m_adaptor;
+            mutable std::vector<uint8_t> m_buf;
+        };
+
+	template <typename Range, typename Adaptor>
+        void build(Range const& strings, Adaptor adaptor)
+        {
+            alphabet_map(strings, adaptor).swap(m_alphabet);
+            Trie(strings, encoding_adaptor<Adaptor>(m_alphabet, adaptor)).swap(m_trie);
+        }
+
+        alphabet_map m_alphabet;
+        trie_type m_trie;
+    };
+
+}
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "succinct/cartesian_tree.hpp"
+
+#include "bit_strings.hpp"
+#include "packed_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Trie with an integer score attached to each key, which returns
+    // the completions of a prefix in decreasing score order. Trie must
+    // provide prefix_range(), so the completions are an id range: the
+    // top-k are extracted with a priority queue of id ranges, each
+    // keyed by its maximum score, which is found with a range maximum
+    // query on the scores
+    template <typename Trie>
+    struct scored_trie
+    {
+        typedef Trie trie_type;
+        typedef std::pair<size_t, uint64_t> result_type; // (id, score)
+
+        scored_trie()
+        {}
+
+	template <typename Range, typename ScoresRange, typename Adaptor>
+        scored_trie(Range const& strings, ScoresRange const& scores, Adaptor adaptor)
+        {
+            build(strings, scores, adaptor);
+        }
+
+	template <typename Range, typename ScoresRange>
+        scored_trie(Range const& strings, ScoresRange const& scores)
+        {
+            build(strings, scores, stl_string_adaptor());
+        }
+
+        // Appends to results the (at most) k completions of the prefix
+        // with the highest score, in decreasing score order
+	template <typename T, typename Adaptor>
+        void top_k(T const& prefix, size_t k, std::vector<result_type>& results, Adaptor adaptor) const
+        {
+            std::pair<size_t, size_t> range = m_trie.prefix_range(prefix, adaptor);
+            if (range.first == range.second || !k) return;
+
+            std::priority_queue<candidate> queue;
+            queue.push(make_candidate(range.first, range.second));
+
+            for (size_t found = 0; found < k && !queue.empty(); ++found) {
+                candidate top = queue.top();
+                queue.pop();
+                results.push_back(result_type(top.idx, top.score));
+
+                if (top.begin < top.idx) {
+                    queue.push(make_candidate(top.begin, top.idx));
+                }
+                if (top.idx + 1 < top.end) {
+                    queue.push(make_candidate(top.idx + 1, top.end));
+                }
+            }
+        }
+
+	template <typename T>
+        void top_k(T const& prefix, size_t k, std::vector<result_type>& results) const
+        {
+            top_k(prefix, k, results, stl_string_adaptor());
+        }
+
+        uint64_t score(size_t idx) const
+        {
+            return m_scores[idx];
+        }
+
+        size_t size() const
+        {
+            return m_scores.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+	void swap(scored_trie& other)
+        {
+            m_trie.swap(other.m_trie);
+            m_scores.swap(other.m_scores);
+            m_max_rmq.swap(other.m_max_rmq);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_trie, "m_trie")
+                (m_scores, "m_scores")
+                (m_max_rmq, "m_max_rmq")
+		;
+        }
+
+    private:
+
+        struct candidate
+        {
+            size_t begin, end;
+            size_t idx;
+            uint64_t score;
+
+            bool operator<(candidate const& other) const
+            {
+                return score < other.score;
+            }
+        };
+
+        candidate make_candidate(size_t begin, size_t end) const
+        {
+            assert(begin < end);
+            candidate ret;
+            ret.begin = begin;
+            ret.end = end;
+            ret.idx = m_max_rmq.rmq(begin, end - 1);
+            ret.score = m_scores[ret.idx];
+            return ret;
+        }
+
+	template <typename Range, typename ScoresRange, typename Adaptor>
+        void build(Range const& strings, ScoresRange const& scores, Adaptor adaptor)
+        {
+            if (std::distance(boost::begin(scores), boost::end(scores))
+                != std::distance(boost::begin(strings), boost::end(strings))) {
+                throw std::invalid_argument("The number of scores does not match the number of strings");
+            }
+            Trie(strings, adaptor).swap(m_trie);
+
+            // scores are given in input order, store them in id order
+            std::vector<uint64_t> scores_by_id(m_trie.size());
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+	    typedef typename boost::range_const_iterator<ScoresRange>::type scores_iterator_t;
+            scores_iterator_t scores_iter = boost::begin(scores);
+            for (iterator_t iter = boost::begin(strings); iter != boost::end(strings); ++iter, ++scores_iter) {
+                size_t idx = m_trie.index(*iter, adaptor);
+                assert(idx < scores_by_id.size());
+                scores_by_id[idx] = *scores_iter;
+            }
+
+            packed_vector(scores_by_id).swap(m_scores);
+            cartesian_tree(scores_by_id, std::greater<uint64_t>()).swap(m_max_rmq);
+        }
+
+        trie_type m_trie;
+        packed_vector m_scores;
+        cartesian_tree m_max_rmq;
+    };
+
+}
+}
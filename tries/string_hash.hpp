@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+namespace succinct {
+namespace tries {
+
+    // MurmurHash64A of the len bytes at s
+    inline uint64_t hash_bytes(const uint8_t* s, size_t len, uint64_t seed = 0)
+    {
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int r = 47;
+        uint64_t h = seed ^ (len * m);
+
+        const uint8_t* end = s + (len & ~size_t(7));
+        for (; s != end; s += 8) {
+            uint64_t k;
+            std::memcpy(&k, s, sizeof(k));
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+
+        switch (len & 7) {
+        case 7: h ^= uint64_t(s[6]) << 48; // fall through
+        case 6: h ^= uint64_t(s[5]) << 40; // fall through
+        case 5: h ^= uint64_t(s[4]) << 32; // fall through
+        case 4: h ^= uint64_t(s[3]) << 24; // fall through
+        case 3: h ^= uint64_t(s[2]) << 16; // fall through
+        case 2: h ^= uint64_t(s[1]) << 8; // fall through
+        case 1: h ^= uint64_t(s[0]);
+            h *= m;
+        };
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
+    // Finalizer of MurmurHash3, a bijective mix of the bits of x
+    inline uint64_t hash_int(uint64_t x, uint64_t seed = 0)
+    {
+        x ^= seed;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+}
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "bit_strings.hpp"
+#include "packed_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Trie that also answers suffix queries. Next to the trie of the
+    // keys, it holds a trie of the reversed keys, so that the keys
+    // ending with a given suffix are a prefix range of the reversed
+    // trie; a packed permutation maps the reversed ids back to the
+    // ids of the forward trie, which remain the ids of the keys. Trie
+    // must provide prefix_range(). The whole structure is mapped and
+    // frozen as one object
+    template <typename Trie>
+    struct suffix_indexed_trie
+    {
+        typedef Trie trie_type;
+
+        suffix_indexed_trie()
+        {}
+
+	template <typename Range, typename Adaptor>
+        suffix_indexed_trie(Range const& strings, Adaptor adaptor)
+        {
+            build(strings, adaptor);
+        }
+
+	template <typename Range>
+        suffix_indexed_trie(Range const& strings)
+        {
+            build(strings, stl_string_adaptor());
+        }
+
+	template <typename T, typename Adaptor>
+	size_t index(T const& val, Adaptor adaptor) const
+	{
+            return m_forward.index(val, adaptor);
+        }
+
+	template <typename T>
+	size_t index(T const& val) const
+	{
+            return m_forward.index(val);
+        }
+
+        std::string operator[](size_t idx) const
+        {
+            return m_forward[idx];
+        }
+
+        // Returns the range [begin, end) of the positions, in the
+        // reversed trie, of the keys ending with the given suffix; use
+        // suffix_id() to get their ids
+	template <typename T, typename Adaptor>
+        std::pair<size_t, size_t> suffix_range(T const& val, Adaptor adaptor) const
+        {
+	    char_range s = adaptor(val);
+            size_t len = boost::size(s);
+            if (len && !s.first[len - 1]) len -= 1; // the terminator is not part of the suffix
+
+            std::string reversed(s.first, s.first + len);
+            std::reverse(reversed.begin(), reversed.end());
+            return m_reversed.prefix_range(reversed);
+        }
+
+	template <typename T>
+        std::pair<size_t, size_t> suffix_range(T const& val) const
+        {
+            return suffix_range(val, stl_string_adaptor());
+        }
+
+	template <typename T, typename Adaptor>
+        size_t suffix_count(T const& val, Adaptor adaptor) const
+        {
+            std::pair<size_t, size_t> range = suffix_range(val, adaptor);
+            return range.second - range.first;
+        }
+
+	template <typename T>
+        size_t suffix_count(T const& val) const
+        {
+            return suffix_count(val, stl_string_adaptor());
+        }
+
+        // Id of the key at the given position of a suffix range
+        size_t suffix_id(size_t pos) const
+        {
+            return m_reversed_ids[pos];
+        }
+
+        size_t size() const
+        {
+            return m_forward.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_forward;
+        }
+
+        trie_type const& get_reversed_trie() const
+        {
+            return m_reversed;
+        }
+
+	void swap(suffix_indexed_trie& other)
+        {
+            m_forward.swap(other.m_forward);
+            m_reversed.swap(other.m_reversed);
+            m_reversed_ids.swap(other.m_reversed_ids);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_forward, "m_forward")
+                (m_reversed, "m_reversed")
+                (m_reversed_ids, "m_reversed_ids")
+		;
+        }
+
+    private:
+
+	template <typename Range, typename Adaptor>
+        void build(Range const& strings, Adaptor adaptor)
+        {
+            Trie(strings, adaptor).swap(m_forward);
+
+            std::vector<std::string> reversed;
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            for (iterator_t iter = boost::begin(strings); iter != boost::end(strings); ++iter) {
+                char_range s = adaptor(*iter);
+                size_t len = boost::size(s);
+                if (len && !s.first[len - 1]) len -= 1;
+                reversed.push_back(std::string(s.first, s.first + len));
+                std::reverse(reversed.back().begin(), reversed.back().end());
+            }
+            std::sort(reversed.begin(), reversed.end());
+            Trie(reversed).swap(m_reversed);
+
+            std::vector<size_t> reversed_ids(reversed.size());
+            for (size_t i = 0; i < reversed.size(); ++i) {
+                std::string key(reversed[i].rbegin(), reversed[i].rend());
+                reversed_ids[m_reversed.index(reversed[i])] = m_forward.index(key);
+            }
+            packed_vector(reversed_ids).swap(m_reversed_ids);
+        }
+
+        trie_type m_forward;
+        trie_type m_reversed;
+        packed_vector m_reversed_ids;
+    };
+
+}
+}
@@ -0,0 +1,89 @@
+#define BOOST_TEST_MODULE cached_trie
+#include "succinct/test_common.hpp"
+
+#include <cstdlib>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "cached_trie.hpp"
+
+typedef succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> trie_type;
+typedef succinct::tries::cached_trie<trie_type> cached_trie_type;
+
+BOOST_AUTO_TEST_CASE(cached_trie)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    trie_type trie(strings);
+
+    // a small cache, so that entries are evicted
+    cached_trie_type cached(trie, 64);
+    srand(42);
+    for (size_t round = 0; round < 20000; ++round) {
+        // skewed: half of the queries on the first 16 strings
+        size_t i = (round % 2) ? rand() % 16 : rand() % strings.size();
+        // the macro evaluates its arguments more than once
+        size_t idx = cached.index(strings[i]);
+        MY_REQUIRE_EQUAL(trie.index(strings[i]), idx, "i = " << i);
+        std::string miss = strings[i] + "X";
+        idx = cached.index(miss);
+        MY_REQUIRE_EQUAL(trie.index(miss), idx, "i = " << i);
+        std::string key = cached[i];
+        MY_REQUIRE_EQUAL(trie[i], key, "i = " << i);
+    }
+
+    cached_trie_type::cache_stats stats = cached.stats();
+    BOOST_REQUIRE_EQUAL(40000, stats.index_hits + stats.index_misses);
+    BOOST_REQUIRE_EQUAL(20000, stats.lookup_hits + stats.lookup_misses);
+    BOOST_REQUIRE(stats.index_hits > 0);
+    BOOST_REQUIRE(stats.lookup_hits > 0);
+
+    // keys too long to be cached are passed through
+    std::string long_key(200, 'A');
+    BOOST_REQUIRE_EQUAL(size_t(-1), cached.index(long_key));
+    BOOST_REQUIRE_EQUAL(size_t(-1), cached.index(long_key));
+}
+
+void query_thread(cached_trie_type const& cached, std::vector<std::string> const& strings,
+                  std::vector<size_t> const& ids, std::vector<std::string> const& keys,
+                  unsigned seed, bool& ok)
+{
+    ok = true;
+    for (size_t round = 0; round < 50000; ++round) {
+        seed = seed * 1103515245 + 12345;
+        size_t i = (seed >> 8) % ((round % 2) ? 32 : strings.size());
+        if (cached.index(strings[i]) != ids[i] || cached[i] != keys[i]) {
+            ok = false;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cached_trie_concurrent)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    trie_type trie(strings);
+    cached_trie_type cached(trie, 256);
+    std::vector<size_t> ids;
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        ids.push_back(trie.index(strings[i]));
+        keys.push_back(trie[i]);
+    }
+
+    const size_t n_threads = 4;
+    bool ok[n_threads];
+    boost::thread_group threads;
+    for (size_t t = 0; t < n_threads; ++t) {
+        threads.create_thread(boost::bind(query_thread, boost::cref(cached), boost::cref(strings),
+                                          boost::cref(ids), boost::cref(keys), unsigned(t + 1), boost::ref(ok[t])));
+    }
+    threads.join_all();
+    for (size_t t = 0; t < n_threads; ++t) {
+        BOOST_REQUIRE(ok[t]);
+    }
+}
@@ -3,9 +3,65 @@
 #include "test_binary_trie_common.hpp"
 
 #include "succinct/gamma_vector.hpp"
+#include "succinct/mapper.hpp"
 #include "centroid_hollow_trie.hpp"
 
 BOOST_AUTO_TEST_CASE(centroid_hollow_trie)
 {
     test_index_binary<succinct::tries::centroid_hollow_trie>();
 }
+
+BOOST_AUTO_TEST_CASE(centroid_hollow_trie_weighted)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    succinct::tries::stl_string_adaptor adaptor;
+
+    // the ids do not depend on the decomposition
+    std::vector<double> weights(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        weights[i] = double(rand() % 1000);
+    }
+    succinct::tries::centroid_hollow_trie trie(strings, adaptor, weights);
+    for (size_t i = 0; i < strings.size(); ++i) {
+	BOOST_REQUIRE_EQUAL(i, trie.index(strings[i], adaptor));
+    }
+
+    // the deepest key gets closer to the root when it is the hottest
+    succinct::tries::centroid_hollow_trie plain_trie(strings, adaptor);
+    size_t hot_key = 0;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (plain_trie.lookup_depth(strings[i]) > plain_trie.lookup_depth(strings[hot_key])) hot_key = i;
+    }
+    std::vector<double> hot_weights(strings.size(), 1);
+    hot_weights[hot_key] = 1e6;
+    succinct::tries::centroid_hollow_trie hot_trie(strings, adaptor, hot_weights);
+    BOOST_REQUIRE(hot_trie.lookup_depth(strings[hot_key]) < plain_trie.lookup_depth(strings[hot_key]));
+    for (size_t i = 0; i < strings.size(); ++i) {
+        size_t depth = 0;
+        size_t idx = hot_trie.index(strings[i], adaptor, depth);
+        MY_REQUIRE_EQUAL(i, idx, "i = " << i);
+        MY_REQUIRE_EQUAL(depth, hot_trie.lookup_depth(strings[i]), "i = " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(centroid_hollow_trie_child_directory)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+
+    size_t thresholds[] = {1, 2, 64, strings.size() * 4};
+    for (size_t k = 0; k < sizeof(thresholds) / sizeof(thresholds[0]); ++k) {
+        succinct::tries::basic_centroid_hollow_trie<true> trie(strings);
+        trie.build_child_directory(thresholds[k]);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            MY_REQUIRE_EQUAL(i, trie.index(strings[i]), "threshold = " << thresholds[k]);
+        }
+    }
+
+    // the directory is mapped only when enabled
+    succinct::tries::centroid_hollow_trie plain_trie(strings);
+    BOOST_REQUIRE_EQUAL(2U, succinct::mapper::size_tree_of(plain_trie)->children.size());
+    succinct::tries::basic_centroid_hollow_trie<true> dir_trie(strings);
+    BOOST_REQUIRE_EQUAL(3U, succinct::mapper::size_tree_of(dir_trie)->children.size());
+}
@@ -3,6 +3,7 @@
 
 #include "succinct/util.hpp"
 #include "compressed_string_pool.hpp"
+#include "test_string_pool_common.hpp"
 
 BOOST_AUTO_TEST_CASE(compressed_string_pool)
 {
@@ -33,3 +34,10 @@ BOOST_AUTO_TEST_CASE(compressed_string_pool)
         MY_REQUIRE_EQUAL(strings[i], sp.get_string(i), "i = " << i);
     }
 }
+
+BOOST_AUTO_TEST_CASE(compressed_string_pool_match)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    test_match<succinct::tries::compressed_string_pool>(std::vector<std::string>(strings_lines.begin(), strings_lines.end()));
+    test_match<succinct::tries::compressed_string_pool>(test_urls());
+}
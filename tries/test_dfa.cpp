@@ -0,0 +1,51 @@
+#define BOOST_TEST_MODULE dfa
+#include "succinct/test_common.hpp"
+
+#include "dfa.hpp"
+
+using succinct::tries::dfa;
+
+BOOST_AUTO_TEST_CASE(dfa_regex)
+{
+    dfa a("(ab|c)*d+e?");
+    BOOST_REQUIRE(a.matches(std::string("d")));
+    BOOST_REQUIRE(a.matches(std::string("ababcdde")));
+    BOOST_REQUIRE(a.matches(std::string("cdd")));
+    BOOST_REQUIRE(!a.matches(std::string("")));
+    BOOST_REQUIRE(!a.matches(std::string("abde ")));
+    BOOST_REQUIRE(!a.matches(std::string("ad")));
+
+    dfa b("[^a-c]\\.[x-]");
+    BOOST_REQUIRE(b.matches(std::string("d.x")));
+    BOOST_REQUIRE(b.matches(std::string("z.-")));
+    BOOST_REQUIRE(!b.matches(std::string("a.x")));
+    BOOST_REQUIRE(!b.matches(std::string("dxx")));
+
+    dfa empty("");
+    BOOST_REQUIRE(empty.matches(std::string("")));
+    BOOST_REQUIRE(!empty.matches(std::string("a")));
+
+    BOOST_CHECK_THROW(dfa("(ab"), std::invalid_argument);
+    BOOST_CHECK_THROW(dfa("ab)"), std::invalid_argument);
+    BOOST_CHECK_THROW(dfa("*a"), std::invalid_argument);
+    BOOST_CHECK_THROW(dfa("[ab"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(dfa_glob)
+{
+    dfa a("a*b?.c[!x-z]", dfa::glob_syntax);
+    BOOST_REQUIRE(a.matches(std::string("ab1.cw")));
+    BOOST_REQUIRE(a.matches(std::string("axxxbb.ca")));
+    BOOST_REQUIRE(!a.matches(std::string("ab1xcw")));
+    BOOST_REQUIRE(!a.matches(std::string("ab1.cy")));
+    BOOST_REQUIRE(!a.matches(std::string("b1.cw")));
+
+    dfa b("(a)+|\\*", dfa::glob_syntax);
+    BOOST_REQUIRE(b.matches(std::string("(a)+|*")));
+    BOOST_REQUIRE(!b.matches(std::string("a")));
+
+    // dead states prune the search
+    dfa c("abc*", dfa::glob_syntax);
+    dfa::state_type state = c.next(c.initial_state(), 'x');
+    BOOST_REQUIRE(c.is_dead(state));
+}
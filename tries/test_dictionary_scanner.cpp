@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE dictionary_scanner
+#include "succinct/test_common.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "dictionary_scanner.hpp"
+
+typedef std::vector<std::pair<std::pair<size_t, size_t>, size_t> > occurrences_type; // ((pos, length), id)
+
+struct collect_visitor
+{
+    collect_visitor(occurrences_type& occurrences)
+        : m_occurrences(occurrences)
+    {}
+
+    void operator()(size_t pos, size_t length, size_t idx)
+    {
+        m_occurrences.push_back(std::make_pair(std::make_pair(pos, length), idx));
+    }
+
+    occurrences_type& m_occurrences;
+};
+
+template <typename Trie>
+void test_dictionary_scanner()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    strings.push_back("a");
+    strings.push_back("an");
+    Trie trie(strings);
+    std::set<std::string> dictionary(strings.begin(), strings.end());
+    size_t max_length = 0;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        max_length = std::max(max_length, strings[i].size());
+    }
+
+    // names separated by random noise, with a few embedded 0s
+    srand(42);
+    std::string text;
+    for (size_t i = 0; i < 2000; ++i) {
+        text += strings[rand() % strings.size()];
+        size_t noise = rand() % 4;
+        for (size_t j = 0; j < noise; ++j) {
+            text += "xyz an\0"[rand() % 7];
+        }
+    }
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(text.data());
+    succinct::tries::dictionary_scanner<Trie> scanner(trie);
+
+    occurrences_type expected, results;
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        for (size_t length = 1; length <= max_length && pos + length <= text.size(); ++length) {
+            std::string candidate = text.substr(pos, length);
+            if (dictionary.count(candidate)) {
+                expected.push_back(std::make_pair(std::make_pair(pos, length), trie.index(candidate)));
+            }
+        }
+    }
+    collect_visitor all_visitor(results);
+    scanner.find_all(s, text.size(), all_visitor);
+    MY_REQUIRE_EQUAL(expected.size(), results.size(), "find_all");
+    BOOST_REQUIRE(expected == results);
+
+    occurrences_type expected_segments, segments;
+    for (size_t i = 0; i < expected.size(); ) {
+        // take the longest occurrence at the first position, then skip past it
+        size_t pos = expected[i].first.first;
+        size_t j = i;
+        while (j + 1 < expected.size() && expected[j + 1].first.first == pos) ++j;
+        expected_segments.push_back(expected[j]);
+        size_t end = pos + expected[j].first.second;
+        while (j < expected.size() && expected[j].first.first < end) ++j;
+        i = j;
+    }
+    collect_visitor segment_visitor(segments);
+    scanner.segment(s, text.size(), segment_visitor);
+    MY_REQUIRE_EQUAL(expected_segments.size(), segments.size(), "segment");
+    BOOST_REQUIRE(expected_segments == segments);
+}
+
+BOOST_AUTO_TEST_CASE(dictionary_scanner)
+{
+    test_dictionary_scanner<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_dictionary_scanner<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE filtered_trie
+#include "succinct/test_common.hpp"
+#include "test_binary_trie_common.hpp"
+
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "centroid_hollow_trie.hpp"
+#include "filtered_trie.hpp"
+
+BOOST_AUTO_TEST_CASE(xor_filter)
+{
+    std::vector<uint64_t> hashes;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        hashes.push_back(succinct::tries::hash_int(i));
+    }
+    succinct::tries::xor_filter filter(hashes);
+    BOOST_REQUIRE(filter.size_in_bytes() * 8.0 / hashes.size() < 10);
+
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        BOOST_REQUIRE(filter.contains(hashes[i]));
+    }
+
+    size_t false_positives = 0;
+    for (uint64_t i = hashes.size(); i < 2 * hashes.size(); ++i) {
+        false_positives += filter.contains(succinct::tries::hash_int(i));
+    }
+    // expected rate is 1/256
+    BOOST_REQUIRE(false_positives < hashes.size() / 128);
+
+    // an empty set has no false positives
+    succinct::tries::xor_filter empty((std::vector<uint64_t>()));
+    BOOST_REQUIRE_EQUAL(0U, empty.size_in_bytes());
+    for (uint64_t i = 0; i < hashes.size(); ++i) {
+        BOOST_REQUIRE(!empty.contains(hashes[i]));
+    }
+}
+
+template <typename Trie>
+void test_filtered_trie()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+    succinct::tries::filtered_trie<Trie> filtered(strings);
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(trie.index(strings[i]), filtered.index(strings[i]), "i = " << i);
+        std::string miss = strings[i] + "X";
+        MY_REQUIRE_EQUAL(trie.index(miss), filtered.index(miss), "i = " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(filtered_trie)
+{
+    test_trie_roundtrip<succinct::tries::filtered_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> > >();
+    test_filtered_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+
+    // hollow tries return an arbitrary id for non-keys, the filter
+    // turns most of them into -1
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    succinct::tries::filtered_trie<succinct::tries::centroid_hollow_trie> filtered(strings);
+    size_t rejected = 0;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(i, filtered.index(strings[i]), "i = " << i);
+        rejected += filtered.index(strings[i] + "X") == size_t(-1);
+    }
+    BOOST_REQUIRE(rejected > strings.size() * 9 / 10);
+}
+
+BOOST_AUTO_TEST_CASE(filtered_trie_empty)
+{
+    std::vector<std::string> strings;
+    succinct::tries::filtered_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> > filtered(strings);
+
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> queries(strings_lines.begin(), strings_lines.end());
+    queries.push_back("");
+    for (size_t i = 0; i < queries.size(); ++i) {
+        MY_REQUIRE_EQUAL(size_t(-1), filtered.index(queries[i]), "i = " << i);
+    }
+}
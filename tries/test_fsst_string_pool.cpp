@@ -0,0 +1,71 @@
+#define BOOST_TEST_MODULE fsst_string_pool
+#include "succinct/test_common.hpp"
+#include "test_binary_trie_common.hpp"
+
+#include "succinct/util.hpp"
+#include "fsst_string_pool.hpp"
+#include "test_string_pool_common.hpp"
+#include "path_decomposed_trie.hpp"
+
+void test_fsst_pool(std::vector<uint16_t> const& strings_stream)
+{
+    succinct::tries::fsst_string_pool sp(strings_stream);
+    BOOST_REQUIRE(sp.symbols() <= 255);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < sp.size(); ++i) {
+        succinct::tries::fsst_string_pool::string_enumerator e = sp.get_string_enumerator(i);
+        while (true) {
+            uint16_t c = e.next();
+            MY_REQUIRE_EQUAL(strings_stream[pos], c, "i = " << i << " pos = " << pos);
+            pos += 1;
+            if (!c) break;
+        }
+    }
+    BOOST_REQUIRE_EQUAL(strings_stream.size(), pos);
+}
+
+BOOST_AUTO_TEST_CASE(fsst_string_pool)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+
+    std::vector<uint16_t> strings_stream;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        strings_stream.insert(strings_stream.end(), strings[i].begin(), strings[i].end());
+        strings_stream.push_back(0);
+    }
+    test_fsst_pool(strings_stream);
+
+    // branching markers and high bytes are escaped
+    std::vector<uint16_t> marked_stream;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        for (size_t j = 0; j < strings[i].size(); ++j) {
+            if ((i + j) % 7 == 0) marked_stream.push_back(uint16_t(256 + (i + j) % 256));
+            if ((i + j) % 11 == 0) marked_stream.push_back(uint16_t(128 + j % 128));
+            marked_stream.push_back(uint8_t(strings[i][j]));
+        }
+        marked_stream.push_back(0);
+    }
+    test_fsst_pool(marked_stream);
+
+    // empty strings only
+    test_fsst_pool(std::vector<uint16_t>(10, 0));
+}
+
+BOOST_AUTO_TEST_CASE(fsst_string_pool_match)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    test_match<succinct::tries::fsst_string_pool>(std::vector<std::string>(strings_lines.begin(), strings_lines.end()));
+    test_match<succinct::tries::fsst_string_pool>(test_urls());
+}
+
+BOOST_AUTO_TEST_CASE(fsst_path_decomposed_trie)
+{
+    test_trie_roundtrip<succinct::tries::path_decomposed_trie<succinct::tries::fsst_string_pool> >();
+    test_index_binary<succinct::tries::path_decomposed_trie<succinct::tries::fsst_string_pool, true> >(true);
+    test_index_binary<succinct::tries::path_decomposed_trie<succinct::tries::fsst_string_pool, true, true> >(true);
+
+    // the uint16_t chars cannot hold the markers of wider symbols
+    BOOST_REQUIRE(!(succinct::tries::detail::labels_pool_fits<succinct::tries::fsst_string_pool, uint16_t>::value));
+}
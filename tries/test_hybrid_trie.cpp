@@ -0,0 +1,44 @@
+#define BOOST_TEST_MODULE hybrid_trie
+#include "succinct/test_common.hpp"
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "compressed_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "hybrid_trie.hpp"
+
+template <typename Trie>
+void test_hybrid_trie()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    std::vector<std::string> queries;
+    queries.push_back("");
+    queries.push_back("A");
+    queries.push_back("Zz");
+    for (size_t i = 0; i < strings.size(); ++i) {
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "X");
+        queries.push_back(strings[i].substr(0, 1));
+        queries.push_back(strings[i].substr(0, 2));
+        queries.push_back(strings[i].substr(0, 3));
+    }
+
+    for (size_t prefix_bytes = 1; prefix_bytes <= 2; ++prefix_bytes) {
+        succinct::tries::hybrid_trie<Trie> hybrid(trie, prefix_bytes);
+        BOOST_REQUIRE_EQUAL(trie.size(), hybrid.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            MY_REQUIRE_EQUAL(trie.index(queries[i]), hybrid.index(queries[i]),
+                             "query = " << queries[i] << " prefix_bytes = " << prefix_bytes);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hybrid_trie)
+{
+    test_hybrid_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_hybrid_trie<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+    test_hybrid_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, true> >();
+}
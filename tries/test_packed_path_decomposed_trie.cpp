@@ -0,0 +1,48 @@
+#define BOOST_TEST_MODULE packed_path_decomposed_trie
+#include "succinct/test_common.hpp"
+#include "test_binary_trie_common.hpp"
+
+#include "vbyte_string_pool.hpp"
+#include "compressed_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "packed_path_decomposed_trie.hpp"
+
+template <typename Trie, typename PackedTrie>
+void test_same_ids()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+    PackedTrie packed(trie);
+    BOOST_REQUIRE_EQUAL(trie.size(), packed.size());
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(trie.index(strings[i]), packed.index(strings[i]), "i = " << i);
+        std::string miss = strings[i] + "X";
+        MY_REQUIRE_EQUAL(trie.index(miss), packed.index(miss), "i = " << i);
+        miss = strings[i].substr(0, strings[i].size() - 1);
+        MY_REQUIRE_EQUAL(trie.index(miss), packed.index(miss), "i = " << i);
+    }
+    for (size_t idx = 0; idx < trie.size(); ++idx) {
+        MY_REQUIRE_EQUAL(trie[idx], packed[idx], "idx = " << idx);
+    }
+
+    // the aligned records move with the trie
+    PackedTrie swapped;
+    swapped.swap(packed);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(trie.index(strings[i]), swapped.index(strings[i]), "i = " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_path_decomposed_trie)
+{
+    test_trie_roundtrip<succinct::tries::packed_path_decomposed_trie<> >();
+    test_index_binary<succinct::tries::packed_path_decomposed_trie<true> >(true);
+    test_trie_roundtrip<succinct::tries::packed_path_decomposed_trie<true> >();
+
+    test_same_ids<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool>,
+                  succinct::tries::packed_path_decomposed_trie<> >();
+    test_same_ids<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true>,
+                  succinct::tries::packed_path_decomposed_trie<true> >();
+}
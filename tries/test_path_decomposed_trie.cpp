@@ -2,9 +2,406 @@
 #include "succinct/test_common.hpp"
 #include "test_binary_trie_common.hpp"
 
+#include <algorithm>
+
+#include "succinct/mapper.hpp"
+
 #include "vbyte_string_pool.hpp"
 #include "compressed_string_pool.hpp"
 #include "path_decomposed_trie.hpp"
+#include "dfa.hpp"
+
+template <typename Trie>
+void test_index_batch()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    // mix members and non-members
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "X");
+        queries.push_back(strings[i].substr(0, strings[i].size() / 2));
+    }
+
+    size_t in_flight[] = {1, 3, 16, 10000};
+    for (size_t k = 0; k < sizeof(in_flight) / sizeof(in_flight[0]); ++k) {
+        std::vector<size_t> ids;
+        trie.index_batch(queries, ids, succinct::tries::stl_string_adaptor(), in_flight[k]);
+        BOOST_REQUIRE_EQUAL(queries.size(), ids.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            MY_REQUIRE_EQUAL(trie.index(queries[i]), ids[i], "i = " << i << " in_flight = " << in_flight[k]);
+        }
+    }
+}
+
+template <typename Trie>
+void test_get_key()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    char buf[256];
+    for (size_t idx = 0; idx < trie.size(); ++idx) {
+        std::string expected = trie[idx];
+        MY_REQUIRE_EQUAL(expected.size(), trie.get_key(idx, buf, sizeof(buf)), "idx = " << idx);
+        MY_REQUIRE_EQUAL(expected, std::string(buf), "idx = " << idx);
+
+        // truncated like snprintf
+        size_t buf_len = expected.size() / 2;
+        MY_REQUIRE_EQUAL(expected.size(), trie.get_key(idx, buf, buf_len), "idx = " << idx);
+        if (buf_len) {
+            MY_REQUIRE_EQUAL(expected.substr(0, buf_len - 1), std::string(buf), "idx = " << idx);
+        }
+    }
+}
+
+template <typename Trie>
+void test_wide_fanout()
+{
+    // groups of every degree, to exercise all the child search strategies
+    size_t degrees[] = {2, 8, 9, 16, 17, 40, 64, 65, 200, 255};
+    for (size_t d = 0; d < sizeof(degrees) / sizeof(degrees[0]); ++d) {
+        std::vector<std::string> strings;
+        for (size_t c = 256 - degrees[d]; c < 256; ++c) {
+            strings.push_back(std::string(1, char(c)) + "x");
+            strings.push_back(std::string(1, char(c)) + "y");
+        }
+        Trie trie(strings);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            size_t idx = trie.index(strings[i]);
+            MY_REQUIRE_EQUAL(strings[i], trie[idx], "degree = " << degrees[d]);
+        }
+        for (size_t c = 1; c < 256; ++c) {
+            bool present = c >= 256 - degrees[d];
+            std::string key = std::string(1, char(c)) + "x";
+            bool found = trie.index(key) != size_t(-1);
+            size_t expected_count = present ? 2 : 0;
+            MY_REQUIRE_EQUAL(present, found, "degree = " << degrees[d] << " c = " << c);
+            MY_REQUIRE_EQUAL(expected_count, trie.prefix_count(std::string(1, char(c))), "degree = " << degrees[d] << " c = " << c);
+        }
+    }
+}
+
+template <typename Trie>
+void test_prefix_range()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    std::vector<std::string> prefixes;
+    prefixes.push_back("");
+    prefixes.push_back("Zzz");
+    for (size_t i = 0; i < strings.size(); i += 7) {
+        for (size_t l = 1; l <= strings[i].size(); ++l) {
+            prefixes.push_back(strings[i].substr(0, l));
+        }
+        prefixes.push_back(strings[i] + "X");
+    }
+
+    for (size_t p = 0; p < prefixes.size(); ++p) {
+        std::string const& prefix = prefixes[p];
+        std::pair<size_t, size_t> range = trie.prefix_range(prefix);
+        size_t count = 0;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (strings[i].compare(0, prefix.size(), prefix) == 0) {
+                size_t idx = trie.index(strings[i]);
+                BOOST_REQUIRE_MESSAGE(idx >= range.first && idx < range.second,
+                                      "prefix = " << prefix << " key = " << strings[i]);
+                count += 1;
+            }
+        }
+        MY_REQUIRE_EQUAL(count, range.second - range.first, "prefix = " << prefix);
+        MY_REQUIRE_EQUAL(count, trie.prefix_count(prefix), "prefix = " << prefix);
+    }
+}
+
+template <typename Trie>
+void test_key_enumerator()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    typename Trie::key_enumerator e = trie.get_key_enumerator();
+    for (size_t i = 0; i < trie.size(); ++i) {
+        std::string key = e.next();
+        MY_REQUIRE_EQUAL(trie[i], key, "i = " << i);
+    }
+
+    for (size_t begin = 1; begin < trie.size(); begin += 97) {
+        typename Trie::key_enumerator e = trie.get_key_enumerator(begin);
+        for (size_t i = begin; i < std::min(trie.size(), begin + 50); ++i) {
+            std::string key = e.next();
+            MY_REQUIRE_EQUAL(trie[i], key, "begin = " << begin << " i = " << i);
+        }
+    }
+}
+
+template <typename Trie>
+void test_lower_bound()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    std::vector<std::string> queries;
+    queries.push_back("");
+    queries.push_back("\x01");
+    queries.push_back("zzz");
+    queries.push_back("\xff");
+    for (size_t i = 0; i < strings.size(); ++i) {
+        std::string const& s = strings[i];
+        queries.push_back(s);
+        queries.push_back(s + "X");
+        queries.push_back(s + "\x01");
+        queries.push_back(s.substr(0, s.size() - 1));
+        for (size_t l = 0; l < s.size(); ++l) {
+            std::string t = s.substr(0, l + 1);
+            t[l] += 1;
+            queries.push_back(t);
+            t[l] -= 2;
+            queries.push_back(t);
+        }
+    }
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        size_t expected = std::lower_bound(strings.begin(), strings.end(), queries[i]) - strings.begin();
+        MY_REQUIRE_EQUAL(expected, trie.lower_bound(queries[i]), "query = " << queries[i]);
+        MY_REQUIRE_EQUAL(expected, trie.rank(queries[i]), "query = " << queries[i]);
+    }
+}
+
+size_t edit_distance(std::string const& a, std::string const& b)
+{
+    std::vector<size_t> prev(b.size() + 1), cur(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) prev[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        cur[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            cur[j] = std::min(std::min(prev[j], cur[j - 1]) + 1, prev[j - 1] + (a[i - 1] != b[j - 1]));
+        }
+        prev.swap(cur);
+    }
+    return prev[b.size()];
+}
+
+template <typename Trie>
+void test_fuzzy_search()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    const char* queries[] = {"", "Al", "Alan", "Mari", "Jonh", "Sandeep", "Zzzzz", "Christopher"};
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); ++q) {
+        for (size_t max_dist = 0; max_dist <= 3; ++max_dist) {
+            std::vector<std::pair<size_t, size_t> > expected, results;
+            for (size_t i = 0; i < strings.size(); ++i) {
+                size_t dist = edit_distance(strings[i], queries[q]);
+                if (dist <= max_dist) {
+                    expected.push_back(std::make_pair(trie.index(strings[i]), dist));
+                }
+            }
+            trie.fuzzy_search(std::string(queries[q]), max_dist, results);
+            std::sort(expected.begin(), expected.end());
+            std::sort(results.begin(), results.end());
+            MY_REQUIRE_EQUAL(expected.size(), results.size(), "query = " << queries[q] << " max_dist = " << max_dist);
+            BOOST_REQUIRE(expected == results);
+        }
+    }
+}
+
+template <typename Trie>
+void test_longest_prefix()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    std::vector<std::string> sorted_strings(strings);
+    std::sort(sorted_strings.begin(), sorted_strings.end());
+    Trie trie(strings);
+
+    std::vector<std::string> queries;
+    queries.push_back("");
+    queries.push_back("Zzzz");
+    for (size_t i = 0; i < strings.size(); ++i) {
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "son");
+        queries.push_back(strings[i].substr(0, strings[i].size() / 2) + "x");
+    }
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        std::pair<size_t, size_t> expected(size_t(-1), 0);
+        for (size_t l = 0; l <= queries[i].size(); ++l) {
+            std::string prefix = queries[i].substr(0, l);
+            if (std::binary_search(sorted_strings.begin(), sorted_strings.end(), prefix)) {
+                expected = std::make_pair(trie.index(prefix), l);
+            }
+        }
+        std::pair<size_t, size_t> result = trie.longest_prefix(queries[i]);
+        MY_REQUIRE_EQUAL(expected.first, result.first, "query = " << queries[i]);
+        MY_REQUIRE_EQUAL(expected.second, result.second, "query = " << queries[i]);
+    }
+}
+
+template <typename Trie>
+void test_match()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    const char* globs[] = {"*", "", "Al*", "*an", "?a*", "[A-C]*[!aeiou]", "*ll*", "Zzz*"};
+    const char* regexes[] = {"(Al|Ma)[a-z]+", "J.*n|K.*", "[^A-M].?.?", "(ab)*", "A(n|l)(d|n)?re.*"};
+
+    std::vector<succinct::tries::dfa> automata;
+    for (size_t i = 0; i < sizeof(globs) / sizeof(globs[0]); ++i) {
+        automata.push_back(succinct::tries::dfa(globs[i], succinct::tries::dfa::glob_syntax));
+    }
+    for (size_t i = 0; i < sizeof(regexes) / sizeof(regexes[0]); ++i) {
+        automata.push_back(succinct::tries::dfa(regexes[i]));
+    }
+
+    for (size_t a = 0; a < automata.size(); ++a) {
+        std::vector<size_t> expected, results;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (automata[a].matches(strings[i])) {
+                expected.push_back(trie.index(strings[i]));
+            }
+        }
+        trie.match(automata[a], std::back_inserter(results));
+        std::sort(expected.begin(), expected.end());
+        std::sort(results.begin(), results.end());
+        MY_REQUIRE_EQUAL(expected.size(), results.size(), "automaton = " << a);
+        BOOST_REQUIRE(expected == results);
+    }
+}
+
+template <typename Trie>
+void test_weighted()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    succinct::tries::stl_string_adaptor adaptor;
+
+    size_t hot_keys[] = {0, strings.size() / 3, strings.size() - 1};
+    for (size_t k = 0; k < sizeof(hot_keys) / sizeof(hot_keys[0]); ++k) {
+        std::vector<double> weights(strings.size(), 1);
+        weights[hot_keys[k]] = 1e6;
+        Trie trie(strings, adaptor, weights);
+
+        // the root path ends at the hottest key
+        MY_REQUIRE_EQUAL(0, trie.index(strings[hot_keys[k]]), "hot key = " << hot_keys[k]);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            size_t idx = trie.index(strings[i]);
+            MY_REQUIRE_EQUAL(strings[i], trie[idx], "i = " << i);
+        }
+    }
+
+    BOOST_CHECK_THROW(Trie(strings, adaptor, std::vector<double>(1)), std::invalid_argument);
+}
+
+template <typename Trie>
+void test_child_directory()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie plain(strings);
+
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "X");
+        queries.push_back(strings[i].substr(0, strings[i].size() / 2));
+    }
+
+    // from every node down to no node at all
+    size_t thresholds[] = {1, 2, 64, strings.size() * 4};
+    for (size_t k = 0; k < sizeof(thresholds) / sizeof(thresholds[0]); ++k) {
+        Trie trie(strings);
+        trie.build_child_directory(thresholds[k]);
+        BOOST_REQUIRE_EQUAL(thresholds[k] <= strings.size(), trie.get_child_directory().size() != 0);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            size_t expected = plain.index(queries[i]);
+            MY_REQUIRE_EQUAL(expected, trie.index(queries[i]), "i = " << i << " threshold = " << thresholds[k]);
+        }
+    }
+}
+
+template <typename Trie>
+std::vector<std::string> mapped_fields()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    Trie trie(strings);
+
+    std::vector<std::string> fields;
+    succinct::mapper::size_node_ptr node = succinct::mapper::size_tree_of(trie);
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        fields.push_back(node->children[i]->name);
+    }
+    return fields;
+}
+
+bool has_field(std::vector<std::string> const& fields, std::string const& name)
+{
+    return std::find(fields.begin(), fields.end(), name) != fields.end();
+}
+
+template <typename SymbolType, bool Lexicographic>
+void test_wide_symbols()
+{
+    typedef succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, Lexicographic, false, SymbolType> trie_type;
+    typedef std::vector<SymbolType> key_type;
+
+    // sequences of token ids, with a large alphabet and shared prefixes
+    srand(42);
+    std::set<key_type> key_set;
+    while (key_set.size() < 5000) {
+        key_type key(1 + rand() % 5);
+        for (size_t j = 0; j < key.size(); ++j) {
+            key[j] = SymbolType(1 + rand() % (j < 2 ? 30 : 60000));
+        }
+        key.push_back(0);
+        key_set.insert(key);
+    }
+    std::vector<key_type> keys(key_set.begin(), key_set.end());
+
+    succinct::tries::stl_vector_adaptor<SymbolType> adaptor;
+    trie_type trie(keys, adaptor);
+    BOOST_REQUIRE_EQUAL(keys.size(), trie.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        size_t idx = trie.index(keys[i], adaptor);
+        if (Lexicographic) {
+            MY_REQUIRE_EQUAL(i, idx, "i = " << i);
+        }
+        key_type key = trie[idx];
+        key.push_back(0);
+        BOOST_REQUIRE(keys[i] == key);
+
+        key_type miss(keys[i]);
+        miss.back() = SymbolType(-1);
+        miss.push_back(0);
+        MY_REQUIRE_EQUAL(size_t(-1), trie.index(miss, adaptor), "i = " << i);
+
+        // the prefix of the first two symbols
+        key_type prefix(keys[i].begin(), keys[i].begin() + std::min(keys[i].size() - 1, size_t(2)));
+        prefix.push_back(0);
+        std::pair<size_t, size_t> range = trie.prefix_range(prefix, adaptor);
+        std::pair<size_t, size_t> expected(std::lower_bound(keys.begin(), keys.end(), prefix) - keys.begin(), 0);
+        prefix.back() = SymbolType(-1);
+        expected.second = std::lower_bound(keys.begin(), keys.end(), prefix) - keys.begin();
+        MY_REQUIRE_EQUAL(expected.second - expected.first, range.second - range.first, "i = " << i);
+        if (Lexicographic) {
+            MY_REQUIRE_EQUAL(expected.first, range.first, "i = " << i);
+        }
+    }
+}
 
 BOOST_AUTO_TEST_CASE(path_decomposed_trie)
 {
@@ -15,4 +412,119 @@ BOOST_AUTO_TEST_CASE(path_decomposed_trie)
     // Lexicographic one also has monotone indexes
     test_index_binary<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
     test_trie_roundtrip<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+
+    // First label chars do not change the ids
+    test_trie_roundtrip<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, true> >();
+    test_index_binary<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true, true> >(true);
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_index_batch)
+{
+    test_index_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_index_batch<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+    test_index_batch<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, true> >();
+    test_index_batch<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_get_key)
+{
+    test_get_key<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_get_key<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+
+    // nested keys are deeper than the fixed ancestor stack
+    std::vector<std::string> nested;
+    for (size_t i = 1; i <= 200; ++i) {
+        nested.push_back(std::string(i, 'a'));
+    }
+    succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> trie(nested);
+    char buf[256];
+    for (size_t idx = 0; idx < trie.size(); ++idx) {
+        MY_REQUIRE_EQUAL(trie[idx].size(), trie.get_key(idx, buf, sizeof(buf)), "idx = " << idx);
+        MY_REQUIRE_EQUAL(trie[idx], std::string(buf), "idx = " << idx);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_wide_fanout)
+{
+    test_wide_fanout<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_wide_fanout<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_prefix_range)
+{
+    test_prefix_range<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_prefix_range<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+    test_prefix_range<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_key_enumerator)
+{
+    test_key_enumerator<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_key_enumerator<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_lower_bound)
+{
+    test_lower_bound<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+    test_lower_bound<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_fuzzy_search)
+{
+    test_fuzzy_search<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_fuzzy_search<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_match)
+{
+    test_match<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_match<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_longest_prefix)
+{
+    test_longest_prefix<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_longest_prefix<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_weighted)
+{
+    test_weighted<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_weighted<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, false, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_wide_symbols)
+{
+    test_wide_symbols<uint16_t, false>();
+    test_wide_symbols<uint16_t, true>();
+    test_wide_symbols<uint32_t, false>();
+    test_wide_symbols<uint32_t, true>();
+
+    // a pool too narrow for the branching markers does not compile
+    BOOST_REQUIRE((succinct::tries::detail::labels_pool_fits<succinct::tries::vbyte_string_pool, uint32_t>::value));
+    BOOST_REQUIRE((succinct::tries::detail::labels_pool_fits<succinct::tries::compressed_string_pool, uint8_t>::value));
+    BOOST_REQUIRE(!(succinct::tries::detail::labels_pool_fits<succinct::tries::compressed_string_pool, uint16_t>::value));
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_child_directory)
+{
+    test_child_directory<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, false, uint8_t, true> >();
+    test_child_directory<succinct::tries::path_decomposed_trie<succinct::tries::compressed_string_pool, true, true, uint8_t, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(path_decomposed_trie_mapped_fields)
+{
+    // the optional fields are mapped only when enabled
+    BOOST_REQUIRE(!has_field(mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >(), "m_first_label_chars"));
+    BOOST_REQUIRE(!has_field(mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >(), "m_first_label_chars"));
+    BOOST_REQUIRE(has_field(mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, true> >(), "m_first_label_chars"));
+    BOOST_REQUIRE(!has_field(mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >(), "m_child_directory"));
+    BOOST_REQUIRE(has_field(mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false, false, uint8_t, true> >(), "m_child_directory"));
+
+    // the default trie maps the same fields as before the optional ones
+    std::vector<std::string> fields = mapped_fields<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    BOOST_REQUIRE_EQUAL(3U, fields.size());
+    BOOST_REQUIRE_EQUAL("m_bp", fields[0]);
+    BOOST_REQUIRE_EQUAL("m_branching_chars", fields[1]);
+    BOOST_REQUIRE_EQUAL("m_labels", fields[2]);
 }
@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE remapped_trie
+#include "succinct/test_common.hpp"
+#include "test_binary_trie_common.hpp"
+
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "hollow_trie.hpp"
+#include "centroid_hollow_trie.hpp"
+#include "succinct/gamma_vector.hpp"
+#include "remapped_trie.hpp"
+
+BOOST_AUTO_TEST_CASE(alphabet_map)
+{
+    std::vector<std::string> strings;
+    strings.push_back("ACGT");
+    strings.push_back("GATTACA");
+    succinct::tries::alphabet_map alphabet(strings, succinct::tries::stl_string_adaptor());
+    BOOST_REQUIRE_EQUAL(4U, alphabet.size());
+    BOOST_REQUIRE_EQUAL(3U, alphabet.bits());
+    BOOST_REQUIRE_EQUAL(1, alphabet.code('A'));
+    BOOST_REQUIRE_EQUAL(4, alphabet.code('T'));
+    BOOST_REQUIRE_EQUAL(0, alphabet.code('X'));
+    BOOST_REQUIRE_EQUAL('G', alphabet.symbol(3));
+
+    // A C G T 0 -> 001 010 011 100 000 (padded)
+    uint8_t buf[8];
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(strings[0].c_str());
+    BOOST_REQUIRE_EQUAL(2U, alphabet.encode(s, 4, buf, true));
+    BOOST_REQUIRE_EQUAL(0x29, buf[0]);
+    BOOST_REQUIRE_EQUAL(0xc0, buf[1]);
+    BOOST_REQUIRE_EQUAL(5U, alphabet.encode(s, 4, buf, false));
+    BOOST_REQUIRE_EQUAL(std::string("ACGT"), alphabet.decode(std::string(buf, buf + 4)));
+
+    const uint8_t* x = reinterpret_cast<const uint8_t*>("AXG");
+    BOOST_REQUIRE_EQUAL(size_t(-1), alphabet.encode(x, 3, buf, true));
+}
+
+// all the k-mers of a small alphabet, sorted
+std::vector<std::string> kmers(std::string const& alphabet, size_t k)
+{
+    std::vector<std::string> ret(1);
+    for (size_t i = 0; i < k; ++i) {
+        std::vector<std::string> next;
+        for (size_t j = 0; j < ret.size(); ++j) {
+            for (size_t c = 0; c < alphabet.size(); ++c) {
+                next.push_back(ret[j] + alphabet[c]);
+            }
+        }
+        ret.swap(next);
+    }
+    return ret;
+}
+
+size_t total_skip(succinct::tries::centroid_hollow_trie const& trie)
+{
+    typedef succinct::tries::centroid_hollow_trie::skips_type skips_type;
+    succinct::forward_enumerator<skips_type> e(trie.get_skips(), 0);
+    size_t ret = 0;
+    for (size_t i = 0; i < trie.get_skips().size(); ++i) {
+        ret += e.next() >> 1;
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(remapped_trie)
+{
+    typedef succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> lex_trie_type;
+    test_index_binary<succinct::tries::remapped_trie<lex_trie_type> >(true);
+    test_trie_roundtrip<succinct::tries::remapped_trie<lex_trie_type> >();
+    test_trie_roundtrip<succinct::tries::remapped_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> > >();
+
+    test_index_binary<succinct::tries::remapped_trie<succinct::tries::centroid_hollow_trie, true> >();
+    test_index_binary<succinct::tries::remapped_trie<succinct::tries::hollow_trie<succinct::gamma_vector>, true> >();
+
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    succinct::tries::remapped_trie<lex_trie_type> trie(strings);
+    BOOST_REQUIRE_EQUAL(size_t(-1), trie.index(strings[0] + "#"));
+}
+
+BOOST_AUTO_TEST_CASE(remapped_trie_small_alphabet)
+{
+    std::vector<std::string> strings = kmers("ACGT", 7);
+    succinct::tries::remapped_trie<succinct::tries::centroid_hollow_trie, true> remapped(strings);
+    succinct::tries::centroid_hollow_trie plain(strings);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(i, remapped.index(strings[i]), "i = " << i);
+    }
+
+    // the skips over the unused bits are gone
+    BOOST_REQUIRE(total_skip(remapped.get_trie()) < total_skip(plain));
+}
@@ -0,0 +1,69 @@
+#define BOOST_TEST_MODULE scored_trie
+#include "succinct/test_common.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "scored_trie.hpp"
+
+template <typename Trie>
+void test_top_k()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    std::vector<uint64_t> scores(strings.size());
+    srand(42);
+    for (size_t i = 0; i < scores.size(); ++i) {
+        scores[i] = rand() % 1000;
+    }
+
+    succinct::tries::scored_trie<Trie> trie(strings, scores);
+    BOOST_REQUIRE_EQUAL(strings.size(), trie.size());
+
+    const char* prefixes[] = {"", "A", "Al", "Ma", "Mar", "Zz", "Wo"};
+    size_t ks[] = {1, 3, 10, 5000};
+    for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); ++p) {
+        std::string prefix = prefixes[p];
+        std::vector<uint64_t> expected;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (strings[i].compare(0, prefix.size(), prefix) == 0) {
+                expected.push_back(scores[i]);
+            }
+        }
+        std::sort(expected.begin(), expected.end(), std::greater<uint64_t>());
+
+        for (size_t j = 0; j < sizeof(ks) / sizeof(ks[0]); ++j) {
+            std::vector<std::pair<size_t, uint64_t> > results;
+            trie.top_k(prefix, ks[j], results);
+            MY_REQUIRE_EQUAL(std::min(ks[j], expected.size()), results.size(), "prefix = " << prefix);
+
+            for (size_t i = 0; i < results.size(); ++i) {
+                MY_REQUIRE_EQUAL(expected[i], results[i].second, "prefix = " << prefix << " i = " << i);
+                MY_REQUIRE_EQUAL(results[i].second, trie.score(results[i].first), "prefix = " << prefix);
+                std::string key = trie.get_trie()[results[i].first];
+                MY_REQUIRE_EQUAL(0, key.compare(0, prefix.size(), prefix), "key = " << key);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scored_trie)
+{
+    test_top_k<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_top_k<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+}
+
+BOOST_AUTO_TEST_CASE(scored_trie_scores_count)
+{
+    typedef succinct::tries::scored_trie<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> > scored_trie_type;
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+
+    std::vector<uint64_t> fewer(strings.size() - 1, 1);
+    BOOST_CHECK_THROW(scored_trie_type(strings, fewer), std::invalid_argument);
+    std::vector<uint64_t> more(strings.size() + 1, 1);
+    BOOST_CHECK_THROW(scored_trie_type(strings, more), std::invalid_argument);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Checks the match() of the string enumerators of Pool against the
+// chars returned by next(), for each string and each mismatch position
+template <typename Pool>
+inline void test_match(std::vector<std::string> const& strings)
+{
+    typedef typename Pool::char_type char_type;
+
+    std::vector<char_type> strings_stream;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        for (size_t j = 0; j < strings[i].size(); ++j) {
+            strings_stream.push_back(uint8_t(strings[i][j]));
+        }
+        strings_stream.push_back(0);
+    }
+    Pool sp(strings_stream);
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        // the string with the terminator never matches past the end
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(strings[i].c_str());
+        typename Pool::string_enumerator e = sp.get_string_enumerator(i);
+        size_t matched = e.match(s, strings[i].size() + 1);
+        MY_REQUIRE_EQUAL(strings[i].size(), matched, "i = " << i);
+        char_type c = e.next();
+        MY_REQUIRE_EQUAL(0, c, "i = " << i);
+
+        // a mismatch at every position, also inside the compressed
+        // words or symbols
+        for (size_t pos = 0; pos < strings[i].size(); ++pos) {
+            char_type expected = uint8_t(strings[i][pos]);
+            std::string query = strings[i];
+            query[pos] = char(query[pos] ^ 1);
+            e = sp.get_string_enumerator(i);
+            matched = e.match(reinterpret_cast<const uint8_t*>(query.c_str()), query.size() + 1);
+            MY_REQUIRE_EQUAL(pos, matched, "i = " << i << " pos = " << pos);
+            c = e.next();
+            MY_REQUIRE_EQUAL(expected, c, "i = " << i << " pos = " << pos);
+
+            // stopping at len resumes at the next char
+            e = sp.get_string_enumerator(i);
+            matched = e.match(s, pos);
+            MY_REQUIRE_EQUAL(pos, matched, "i = " << i << " pos = " << pos);
+            c = e.next();
+            MY_REQUIRE_EQUAL(expected, c, "i = " << i << " pos = " << pos);
+        }
+    }
+}
+
+// Repetitive strings, which give compressed words longer than a SIMD
+// block
+inline std::vector<std::string> test_urls()
+{
+    std::vector<std::string> ret;
+    for (size_t i = 0; i < 1000; ++i) {
+        ret.push_back("http://www.example.com/some/long/path/" + std::string(1, char('a' + i % 26)) + "/index.html");
+    }
+    return ret;
+}
@@ -0,0 +1,45 @@
+#define BOOST_TEST_MODULE suffix_indexed_trie
+#include "succinct/test_common.hpp"
+
+#include <algorithm>
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "suffix_indexed_trie.hpp"
+
+template <typename Trie>
+void test_suffix_range()
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    succinct::tries::suffix_indexed_trie<Trie> trie(strings);
+    BOOST_REQUIRE_EQUAL(strings.size(), trie.size());
+
+    const char* suffixes[] = {"", "a", "n", "an", "ine", "son", "Alan", "xyz"};
+    for (size_t q = 0; q < sizeof(suffixes) / sizeof(suffixes[0]); ++q) {
+        std::string suffix = suffixes[q];
+        std::vector<size_t> expected, results;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (strings[i].size() >= suffix.size() &&
+                strings[i].compare(strings[i].size() - suffix.size(), suffix.size(), suffix) == 0) {
+                expected.push_back(trie.index(strings[i]));
+            }
+        }
+
+        std::pair<size_t, size_t> range = trie.suffix_range(suffix);
+        MY_REQUIRE_EQUAL(expected.size(), trie.suffix_count(suffix), "suffix = " << suffix);
+        for (size_t pos = range.first; pos < range.second; ++pos) {
+            results.push_back(trie.suffix_id(pos));
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(results.begin(), results.end());
+        BOOST_REQUIRE(expected == results);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(suffix_indexed_trie)
+{
+    test_suffix_range<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> >();
+    test_suffix_range<succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> >();
+}
@@ -0,0 +1,93 @@
+#define BOOST_TEST_MODULE trie_map
+#include "succinct/test_common.hpp"
+#include "test_binary_trie_common.hpp"
+
+#include "vbyte_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "value_codecs.hpp"
+#include "trie_map.hpp"
+
+template <typename TrieMap>
+void test_trie_map(std::vector<uint64_t> const& values)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    TrieMap map(strings, values);
+    BOOST_REQUIRE_EQUAL(strings.size(), map.size());
+
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        uint64_t value;
+        bool found = map.get(strings[i], value);
+        BOOST_REQUIRE(found);
+        MY_REQUIRE_EQUAL(values[i], value, "i = " << i);
+        found = map.get(strings[i] + "X", value);
+        BOOST_REQUIRE(!found);
+
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "X");
+    }
+
+    std::vector<uint64_t> results;
+    map.get_batch(queries, results, uint64_t(-1));
+    BOOST_REQUIRE_EQUAL(queries.size(), results.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(values[i], results[2 * i], "i = " << i);
+        MY_REQUIRE_EQUAL(uint64_t(-1), results[2 * i + 1], "i = " << i);
+    }
+
+    // shorter than the prefetch lag
+    map.get_batch(std::vector<std::string>(queries.begin(), queries.begin() + 3), results, 0);
+    BOOST_REQUIRE_EQUAL(3U, results.size());
+    BOOST_REQUIRE_EQUAL(values[0], results[0]);
+    BOOST_REQUIRE_EQUAL(values[1], results[2]);
+}
+
+BOOST_AUTO_TEST_CASE(trie_map)
+{
+    typedef succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool> centroid_type;
+    typedef succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> lex_type;
+
+    succinct::util::mmap_lines strings_lines("propernames");
+    size_t n = std::distance(strings_lines.begin(), strings_lines.end());
+
+    std::vector<uint64_t> random_values, monotone_values, few_values;
+    srand(42);
+    for (size_t i = 0; i < n; ++i) {
+        random_values.push_back(rand());
+        monotone_values.push_back(i * 3 + rand() % 3);
+        few_values.push_back(uint64_t(1) << (rand() % 5 * 10));
+    }
+
+    test_trie_map<succinct::tries::trie_map<centroid_type> >(random_values);
+    test_trie_map<succinct::tries::trie_map<lex_type, succinct::tries::dictionary_values> >(few_values);
+    test_trie_map<succinct::tries::trie_map<centroid_type, succinct::tries::dictionary_values> >(random_values);
+    // monotone in id order only with the lexicographic trie
+    test_trie_map<succinct::tries::trie_map<lex_type, succinct::tries::elias_fano_values> >(monotone_values);
+
+    std::vector<std::string> strings(3);
+    strings[0] = "a"; strings[1] = "b"; strings[2] = "c";
+    std::vector<uint64_t> decreasing(3);
+    decreasing[0] = 3; decreasing[1] = 2; decreasing[2] = 1;
+    BOOST_CHECK_THROW((succinct::tries::trie_map<lex_type, succinct::tries::elias_fano_values>(strings, decreasing)),
+                      std::invalid_argument);
+
+    // the values must be exactly one for each string
+    std::vector<uint64_t> fewer(2, 1);
+    BOOST_CHECK_THROW(succinct::tries::trie_map<lex_type>(strings, fewer), std::invalid_argument);
+    std::vector<uint64_t> more(4, 1);
+    BOOST_CHECK_THROW(succinct::tries::trie_map<lex_type>(strings, more), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(dictionary_values)
+{
+    std::vector<uint64_t> values;
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back((i % 7) * 1000000007ULL);
+    }
+    succinct::tries::dictionary_values dict(values);
+    BOOST_REQUIRE_EQUAL(7U, dict.dictionary_size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        MY_REQUIRE_EQUAL(values[i], dict[i], "i = " << i);
+    }
+}
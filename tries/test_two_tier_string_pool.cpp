@@ -0,0 +1,81 @@
+#define BOOST_TEST_MODULE two_tier_string_pool
+#include "succinct/test_common.hpp"
+
+#include "succinct/util.hpp"
+#include "vbyte_string_pool.hpp"
+#include "compressed_string_pool.hpp"
+#include "path_decomposed_trie.hpp"
+#include "two_tier_string_pool.hpp"
+
+template <typename Pool>
+void test_two_tier_pool(std::vector<std::string> const& strings, std::vector<bool> const& hot)
+{
+    std::vector<uint8_t> strings_stream;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        strings_stream.insert(strings_stream.end(), strings[i].c_str(), strings[i].c_str() + strings[i].size() + 1);
+    }
+
+    succinct::tries::two_tier_string_pool<Pool> sp(strings_stream, hot);
+    BOOST_REQUIRE_EQUAL(strings.size(), sp.size());
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(bool(hot[i]), sp.is_hot(i), "i = " << i);
+        typename succinct::tries::two_tier_string_pool<Pool>::string_enumerator e = sp.get_string_enumerator(i);
+        for (size_t pos = 0; pos < strings[i].size(); ++pos) {
+            uint8_t c = e.next();
+            MY_REQUIRE_EQUAL(strings[i][pos], c, "i = " << i << " pos = " << pos);
+        }
+        uint8_t c = e.next();
+        MY_REQUIRE_EQUAL(0, c, "i = " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(two_tier_string_pool)
+{
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+
+    std::vector<bool> hot(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        hot[i] = (i % 5) == 0;
+    }
+    test_two_tier_pool<succinct::tries::vbyte_string_pool>(strings, hot);
+    test_two_tier_pool<succinct::tries::compressed_string_pool>(strings, hot);
+
+    // a single tier
+    test_two_tier_pool<succinct::tries::vbyte_string_pool>(strings, std::vector<bool>(strings.size(), false));
+    test_two_tier_pool<succinct::tries::vbyte_string_pool>(strings, std::vector<bool>(strings.size(), true));
+}
+
+BOOST_AUTO_TEST_CASE(two_tier_label_placement)
+{
+    typedef succinct::tries::path_decomposed_trie<succinct::tries::two_tier_string_pool<succinct::tries::vbyte_string_pool> > trie_type;
+
+    succinct::util::mmap_lines strings_lines("propernames");
+    std::vector<std::string> strings(strings_lines.begin(), strings_lines.end());
+    trie_type trie(strings);
+    BOOST_REQUIRE_EQUAL(0U, trie.get_labels().hot_size());
+
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        ids.push_back(trie.index(strings[i]));
+    }
+
+    // a skewed query log, with some misses
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < strings.size(); i += 10) {
+        queries.push_back(strings[i]);
+        queries.push_back(strings[i] + "X");
+    }
+    trie.optimize_label_placement(queries, 0.05);
+
+    size_t hot_size = trie.get_labels().hot_size();
+    BOOST_REQUIRE(hot_size > 0);
+    BOOST_REQUIRE(hot_size <= size_t(0.05 * trie.size()));
+    BOOST_REQUIRE(trie.get_labels().is_hot(0)); // every query reads the root label
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        MY_REQUIRE_EQUAL(ids[i], trie.index(strings[i]), "i = " << i);
+        MY_REQUIRE_EQUAL(strings[i], trie[ids[i]], "i = " << i);
+    }
+}
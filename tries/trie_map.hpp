@@ -0,0 +1,163 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "bit_strings.hpp"
+#include "packed_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Map from strings to integers: the values are stored in id order
+    // with ValueCodec (packed_vector, or one of value_codecs.hpp), so
+    // the ids returned by the trie index them directly. The trie and
+    // the values are mapped and frozen as one object. With the hollow
+    // tries, which do not reject the strings that are not keys, get()
+    // returns an arbitrary value for them (see filtered_trie)
+    template <typename Trie, typename ValueCodec = packed_vector>
+    struct trie_map
+    {
+        typedef Trie trie_type;
+        typedef ValueCodec values_type;
+        typedef typename ValueCodec::value_type value_type;
+
+        trie_map()
+        {}
+
+        // values are given in the order of the strings
+	template <typename Range, typename ValuesRange, typename Adaptor>
+        trie_map(Range const& strings, ValuesRange const& values, Adaptor adaptor)
+        {
+            build(strings, values, adaptor);
+        }
+
+	template <typename Range, typename ValuesRange>
+        trie_map(Range const& strings, ValuesRange const& values)
+        {
+            build(strings, values, stl_string_adaptor());
+        }
+
+        // Returns false if the key is not in the map
+	template <typename T, typename Adaptor>
+        bool get(T const& key, value_type& value, Adaptor adaptor) const
+        {
+            size_t idx = m_trie.index(key, adaptor);
+            if (idx == size_t(-1)) return false;
+            value = m_values[idx];
+            return true;
+        }
+
+	template <typename T>
+        bool get(T const& key, value_type& value) const
+        {
+            return get(key, value, stl_string_adaptor());
+        }
+
+        // Looks up all the keys in the range, storing in values their
+        // values, or missing for the keys not in the map. The value of
+        // each key is prefetched as soon as its id is known, and read
+        // after the following lookups
+	template <typename Range, typename Adaptor>
+        void get_batch(Range const& keys, std::vector<value_type>& values, value_type missing, Adaptor adaptor) const
+        {
+            static const size_t lag = 8;
+            size_t ids[lag];
+
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            values.clear();
+            size_t n = 0;
+            for (iterator_t iter = boost::begin(keys); iter != boost::end(keys); ++iter, ++n) {
+                if (n >= lag) {
+                    values.push_back(read(ids[n % lag], missing));
+                }
+                size_t idx = m_trie.index(*iter, adaptor);
+                if (idx != size_t(-1)) m_values.prefetch(idx);
+                ids[n % lag] = idx;
+            }
+            for (size_t i = n > lag ? n - lag : 0; i < n; ++i) {
+                values.push_back(read(ids[i % lag], missing));
+            }
+        }
+
+	template <typename Range>
+        void get_batch(Range const& keys, std::vector<value_type>& values, value_type missing) const
+        {
+            get_batch(keys, values, missing, stl_string_adaptor());
+        }
+
+        // Value of the key with the given id
+        value_type value(size_t idx) const
+        {
+            return m_values[idx];
+        }
+
+        size_t size() const
+        {
+            return m_values.size();
+        }
+
+        trie_type const& get_trie() const
+        {
+            return m_trie;
+        }
+
+        values_type const& get_values() const
+        {
+            return m_values;
+        }
+
+	void swap(trie_map& other)
+        {
+            m_trie.swap(other.m_trie);
+            m_values.swap(other.m_values);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_trie, "m_trie")
+                (m_values, "m_values")
+		;
+        }
+
+    private:
+
+        value_type read(size_t idx, value_type missing) const
+        {
+            return idx == size_t(-1) ? missing : m_values[idx];
+        }
+
+	template <typename Range, typename ValuesRange, typename Adaptor>
+        void build(Range const& strings, ValuesRange const& values, Adaptor adaptor)
+        {
+            Trie(strings, adaptor).swap(m_trie);
+
+            // values are given in input order, store them in id order
+            std::vector<uint64_t> values_by_id(m_trie.size());
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+	    typedef typename boost::range_const_iterator<ValuesRange>::type values_iterator_t;
+            values_iterator_t values_iter = boost::begin(values);
+            for (iterator_t iter = boost::begin(strings); iter != boost::end(strings); ++iter, ++values_iter) {
+                if (values_iter == boost::end(values)) {
+                    throw std::invalid_argument("Fewer values than strings");
+                }
+                size_t idx = m_trie.index(*iter, adaptor);
+                assert(idx < values_by_id.size());
+                values_by_id[idx] = *values_iter;
+            }
+            if (values_iter != boost::end(values)) {
+                throw std::invalid_argument("More values than strings");
+            }
+
+            ValueCodec(values_by_id).swap(m_values);
+        }
+
+        trie_type m_trie;
+        values_type m_values;
+    };
+
+}
+}
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <math.h>
+#include <stdlib.h>
+
+#include <boost/foreach.hpp>
 
 #include "compacted_trie_builder.hpp"
 #include "patricia_builder.hpp"
@@ -176,9 +179,74 @@ double avg_height(succinct::bp_vector const& bp)
     return double(s.cum_height) / s.n_nodes;
 }
 
+// Depth, in the path decomposed tree, of each node of a DFUDS trie
+// (in node order); a node is always after its parent
+std::vector<size_t> pathdec_depths(succinct::bp_vector const& bp)
+{
+    std::vector<size_t> depths(bp.size() / 2);
+    for (size_t node = 1; node < depths.size(); ++node) {
+	size_t opener = bp.find_open(bp.select0(node - 1));
+	size_t parent = opener - bp.rank(opener);
+	depths[node] = depths[parent] + 1;
+    }
+    return depths;
+}
+
+// Expected number of nodes visited by a lookup when the keys are
+// queried with the given weights
+template <typename Trie>
+double expected_depth(Trie const& t, succinct::util::mmap_lines const& lines, std::vector<double> const& weights)
+{
+    std::vector<size_t> depths = pathdec_depths(t.get_bp());
+    double cum_depth = 0, cum_weight = 0;
+    size_t i = 0;
+    BOOST_FOREACH(std::string const& line, lines) {
+	cum_depth += weights[i] * (depths[t.index(line)] + 1);
+	cum_weight += weights[i];
+	++i;
+    }
+    return cum_depth / cum_weight;
+}
+
+// In the hollow trie the ids are not the node ids, so the trie counts
+// the nodes visited by each lookup
+double expected_depth(succinct::tries::centroid_hollow_trie const& t, succinct::util::mmap_lines const& lines, std::vector<double> const& weights)
+{
+    double cum_depth = 0, cum_weight = 0;
+    size_t i = 0;
+    BOOST_FOREACH(std::string const& line, lines) {
+	cum_depth += weights[i] * t.lookup_depth(line);
+	cum_weight += weights[i];
+	++i;
+    }
+    return cum_depth / cum_weight;
+}
+
+// Usage: trie_stats <strings> [<weights>]
+// The optional weights file has one number per line, the query
+// frequency of the string on the same line; with it, the expected
+// lookup depths are reported, also for the tries built with the
+// weights. Otherwise all the strings have the same weight
 int main(int argc, char** argv)
 {
     succinct::util::mmap_lines lines(argv[1]);
+    std::vector<double> weights;
+    if (argc > 2) {
+	BOOST_FOREACH(std::string const& line, succinct::util::mmap_lines(argv[2])) {
+	    weights.push_back(atof(line.c_str()));
+	}
+    } else {
+	BOOST_FOREACH(std::string const& line, lines) {
+	    (void)line;
+	    weights.push_back(1);
+	}
+    }
+    bool weighted = argc > 2;
+    if (weights.size() != size_t(std::distance(lines.begin(), lines.end()))) {
+	std::cerr << "The number of weights does not match the number of strings" << std::endl;
+	return 1;
+    }
+
     { // compacted trie
 	stats_visitor v;
 	succinct::tries::compacted_trie_builder<stats_visitor> builder;
@@ -199,17 +267,33 @@ int main(int argc, char** argv)
 	succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false> t(lines);
 	std::cout << "centroid_byte_avg_height\t" << avg_height(t.get_bp()) << std::endl;
 	std::cout << "centroid_byte_bitsize\t" << succinct::mapper::size_of(t) * 8 << std::endl;
+	std::cout << "centroid_byte_expected_depth\t" << expected_depth(t, lines, weights) << std::endl;
+    }
+
+    if (weighted) { // centroid trie decomposed by weight
+	succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, false>
+	    t(lines, succinct::tries::stl_string_adaptor(), weights);
+	std::cout << "weighted_byte_avg_height\t" << avg_height(t.get_bp()) << std::endl;
+	std::cout << "weighted_byte_expected_depth\t" << expected_depth(t, lines, weights) << std::endl;
     }
 
     { // lex trie
 	succinct::tries::path_decomposed_trie<succinct::tries::vbyte_string_pool, true> t(lines);
 	std::cout << "lex_byte_avg_height\t" << avg_height(t.get_bp()) << std::endl;
 	std::cout << "lex_byte_bitsize\t" << succinct::mapper::size_of(t) * 8 << std::endl;
+	std::cout << "lex_byte_expected_depth\t" << expected_depth(t, lines, weights) << std::endl;
     }
 
     { // centroid hollow trie
 	succinct::tries::centroid_hollow_trie t(lines);
 	std::cout << "centroid_hollow_avg_height\t" << avg_height(t.get_bp()) << std::endl;
+	std::cout << "centroid_hollow_expected_depth\t" << expected_depth(t, lines, weights) << std::endl;
+    }
+
+    if (weighted) { // centroid hollow trie decomposed by weight
+	succinct::tries::centroid_hollow_trie t(lines, succinct::tries::stl_string_adaptor(), weights);
+	std::cout << "weighted_hollow_avg_height\t" << avg_height(t.get_bp()) << std::endl;
+	std::cout << "weighted_hollow_expected_depth\t" << expected_depth(t, lines, weights) << std::endl;
     }
 
 }
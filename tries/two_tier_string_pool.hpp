@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vector>
+
+#include "succinct/rs_bit_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // String pool split in two pools of type Pool: a hot one, with the
+    // strings that are accessed most often, and a cold one with the
+    // others, each keeping the original order. A rank bit vector maps
+    // the string indexes to the position in their tier. When mapped,
+    // the hot strings are in a compact region at the beginning of the
+    // pool, so that the lookups touch fewer pages.
+    //
+    // Built from a strings sequence all the strings are cold;
+    // place() moves a given set of strings to the hot tier (see
+    // path_decomposed_trie::optimize_label_placement())
+    template <typename Pool>
+    struct two_tier_string_pool
+    {
+        typedef Pool pool_type;
+        typedef typename Pool::char_type char_type;
+        typedef typename Pool::string_enumerator string_enumerator;
+
+        two_tier_string_pool() {}
+
+	template <typename Range>
+        two_tier_string_pool(Range const& strings_seq)
+        {
+            build(strings_seq, std::vector<bool>());
+        }
+
+	template <typename Range>
+        two_tier_string_pool(Range const& strings_seq, std::vector<bool> const& hot)
+        {
+            build(strings_seq, hot);
+        }
+
+        size_t size() const
+        {
+            return m_hot.size();
+        }
+
+        size_t hot_size() const
+        {
+            return m_hot.num_ones();
+        }
+
+        bool is_hot(size_t idx) const
+        {
+            return m_hot[idx];
+        }
+
+        string_enumerator get_string_enumerator(size_t idx) const
+        {
+            if (m_hot[idx]) {
+                return m_hot_pool.get_string_enumerator(m_hot.rank(idx));
+            } else {
+                return m_cold_pool.get_string_enumerator(m_hot.rank0(idx));
+            }
+        }
+
+        std::string get_string(size_t idx) const
+        {
+            // only for debug
+            if (m_hot[idx]) {
+                return m_hot_pool.get_string(m_hot.rank(idx));
+            } else {
+                return m_cold_pool.get_string(m_hot.rank0(idx));
+            }
+        }
+
+        // Rebuilds the pool with the strings i such that hot[i] in the
+        // hot tier
+        void place(std::vector<bool> const& hot)
+        {
+            assert(hot.size() == size());
+            std::vector<char_type> strings_seq;
+            for (size_t i = 0; i < size(); ++i) {
+                string_enumerator e = get_string_enumerator(i);
+                char_type c;
+                while ((c = e.next()) != 0) {
+                    strings_seq.push_back(c);
+                }
+                strings_seq.push_back(0);
+            }
+            two_tier_string_pool(strings_seq, hot).swap(*this);
+        }
+
+        void swap(two_tier_string_pool& other)
+        {
+            m_hot.swap(other.m_hot);
+            m_hot_pool.swap(other.m_hot_pool);
+            m_cold_pool.swap(other.m_cold_pool);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_hot, "m_hot")
+                (m_hot_pool, "m_hot_pool")
+                (m_cold_pool, "m_cold_pool")
+                ;
+        }
+
+        pool_type const& get_hot_pool() const
+        {
+            return m_hot_pool;
+        }
+
+        pool_type const& get_cold_pool() const
+        {
+            return m_cold_pool;
+        }
+
+    private:
+
+	template <typename Range>
+        void build(Range const& strings_seq, std::vector<bool> hot)
+        {
+            // split the sequence by tier; an empty hot vector means
+            // that all the strings are cold
+            std::vector<char_type> tiers[2];
+            size_t n = 0;
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            for (iterator_t iter = boost::begin(strings_seq); iter != boost::end(strings_seq); ++iter) {
+                bool is_hot = n < hot.size() && hot[n];
+                tiers[is_hot].push_back(*iter);
+                if (!*iter) ++n;
+            }
+            assert(hot.empty() || hot.size() == n);
+            hot.resize(n);
+
+            rs_bit_vector(hot).swap(m_hot);
+            // an empty tier is never accessed
+            if (!tiers[1].empty()) Pool(tiers[1]).swap(m_hot_pool);
+            if (!tiers[0].empty()) Pool(tiers[0]).swap(m_cold_pool);
+        }
+
+        rs_bit_vector m_hot;
+        pool_type m_hot_pool;
+        pool_type m_cold_pool;
+    };
+
+}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "succinct/elias_fano.hpp"
+
+#include "packed_vector.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Value arrays for trie_map. Besides packed_vector (fixed width,
+    // the minimum for the largest value), a codec must provide
+    // construction from a range of integers, operator[], prefetch(),
+    // size(), swap() and map()
+
+    // Non-decreasing values, stored with Elias-Fano in about
+    // 2 + log(max / n) bits each; for example offsets into another
+    // array, which are monotone when the ids follow the key order
+    // (lexicographic tries)
+    struct elias_fano_values
+    {
+        typedef uint64_t value_type;
+
+        elias_fano_values()
+        {}
+
+	template <typename Range>
+        elias_fano_values(Range const& ints)
+        {
+	    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+            uint64_t n = 0, last = 0;
+            for (iterator_t iter = boost::begin(ints); iter != boost::end(ints); ++iter) {
+                if (uint64_t(*iter) < last) {
+                    throw std::invalid_argument("Values are not monotone");
+                }
+                last = *iter;
+                n += 1;
+            }
+
+            elias_fano::elias_fano_builder builder(last + 1, n);
+            for (iterator_t iter = boost::begin(ints); iter != boost::end(ints); ++iter) {
+                builder.push_back(*iter);
+            }
+            elias_fano(&builder, false).swap(m_values);
+        }
+
+        value_type operator[](size_t i) const
+        {
+            return m_values.select(i);
+        }
+
+        void prefetch(size_t) const
+        {
+            // the position of the value is only known after the select
+        }
+
+        size_t size() const
+        {
+            return m_values.num_ones();
+        }
+
+        void swap(elias_fano_values& other)
+        {
+            m_values.swap(other.m_values);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_values, "m_values")
+                ;
+        }
+
+    private:
+        elias_fano m_values;
+    };
+
+    // Values with few distinct elements: the sorted distinct values
+    // are stored once, and each value is the packed index of its entry
+    struct dictionary_values
+    {
+        typedef uint64_t value_type;
+
+        dictionary_values()
+        {}
+
+	template <typename Range>
+        dictionary_values(Range const& ints)
+        {
+            std::vector<uint64_t> values(boost::begin(ints), boost::end(ints));
+            std::vector<uint64_t> dictionary(values);
+            std::sort(dictionary.begin(), dictionary.end());
+            dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+
+            std::vector<uint64_t> codes(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                codes[i] = std::lower_bound(dictionary.begin(), dictionary.end(), values[i]) - dictionary.begin();
+            }
+            packed_vector(dictionary).swap(m_dictionary);
+            packed_vector(codes).swap(m_codes);
+        }
+
+        value_type operator[](size_t i) const
+        {
+            return m_dictionary[m_codes[i]];
+        }
+
+        void prefetch(size_t i) const
+        {
+            m_codes.prefetch(i);
+        }
+
+        size_t size() const
+        {
+            return m_codes.size();
+        }
+
+        size_t dictionary_size() const
+        {
+            return m_dictionary.size();
+        }
+
+        void swap(dictionary_values& other)
+        {
+            m_dictionary.swap(other.m_dictionary);
+            m_codes.swap(other.m_codes);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_dictionary, "m_dictionary")
+                (m_codes, "m_codes")
+                ;
+        }
+
+    private:
+        packed_vector m_dictionary;
+        packed_vector m_codes;
+    };
+
+}
+}
@@ -66,6 +66,25 @@ namespace tries {
                 return val;
             }
 
+            // Skips the chars of the string that are equal to the
+            // first symbols of s, stopping at the first char that
+            // differs, which next() returns. Returns the number of
+            // chars skipped, at most len
+            template <typename Symbol>
+            size_t match(const Symbol* s, size_t len)
+            {
+                assert(m_sp);
+                size_t matched = 0;
+                while (matched < len && m_begin != m_end) {
+                    char_type val;
+                    size_t val_len = decode_vbyte(m_sp->m_byte_streams, m_begin, val);
+                    if (val != s[matched]) break;
+                    m_begin += val_len;
+                    matched += 1;
+                }
+                return matched;
+            }
+
             friend struct vbyte_string_pool;
         private:
             string_enumerator(vbyte_string_pool const* sp, size_t idx)
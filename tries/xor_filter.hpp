@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/range.hpp>
+
+#include "succinct/mappable_vector.hpp"
+
+#include "string_hash.hpp"
+
+namespace succinct {
+namespace tries {
+
+    // Xor filter with 8-bit fingerprints (Graf and Lemire, "Xor Filters:
+    // Faster and Smaller Than Bloom and Cuckoo Filters"): an approximate
+    // set of 64-bit hashes taking about 9.84 bits per element, with a
+    // false positive rate of about 1/256 and no false negatives. A
+    // query reads three bytes, one in each third of the table
+    struct xor_filter
+    {
+        xor_filter()
+            : m_seed(0)
+            , m_block_length(0)
+        {}
+
+	template <typename Range>
+        xor_filter(Range const& hashes)
+        {
+            std::vector<uint64_t> keys(boost::begin(hashes), boost::end(hashes));
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            build(keys);
+        }
+
+        bool contains(uint64_t hash) const
+        {
+            if (!m_block_length) return false;
+            uint64_t k = hash_int(hash, m_seed);
+            uint8_t f = m_fingerprints[position(k, 0)]
+                ^ m_fingerprints[position(k, 1)]
+                ^ m_fingerprints[position(k, 2)];
+            return f == fingerprint(k);
+        }
+
+        size_t size_in_bytes() const
+        {
+            return m_fingerprints.size();
+        }
+
+        void swap(xor_filter& other)
+        {
+            std::swap(m_seed, other.m_seed);
+            std::swap(m_block_length, other.m_block_length);
+            m_fingerprints.swap(other.m_fingerprints);
+        }
+
+        template <typename Visitor>
+        void map(Visitor& visit) {
+            visit
+                (m_seed, "m_seed")
+                (m_block_length, "m_block_length")
+                (m_fingerprints, "m_fingerprints")
+                ;
+        }
+
+    private:
+
+        static uint8_t fingerprint(uint64_t k)
+        {
+            return uint8_t(k ^ (k >> 32));
+        }
+
+        size_t position(uint64_t k, size_t block) const
+        {
+            uint64_t r = k;
+            if (block) r = (k << (21 * block)) | (k >> (64 - 21 * block));
+            return size_t(((r & 0xffffffffULL) * m_block_length) >> 32) + block * m_block_length;
+        }
+
+        void build(std::vector<uint64_t> const& keys)
+        {
+            size_t n = keys.size();
+            m_seed = 0;
+            if (!n) {
+                // contains() rejects everything without reading the table
+                m_block_length = 0;
+                mapper::mappable_vector<uint8_t>().swap(m_fingerprints);
+                return;
+            }
+            m_block_length = (32 + (123 * n + 99) / 100) / 3;
+            size_t size = 3 * m_block_length;
+
+            std::vector<uint32_t> counts(size);
+            std::vector<uint64_t> xor_masks(size);
+            std::vector<size_t> queue;
+            std::vector<std::pair<size_t, uint64_t> > stack; // (position, key)
+
+            for (m_seed = 0; ; ++m_seed) {
+                if (m_seed == 100) {
+                    // practically impossible with distinct hashes
+                    throw std::runtime_error("Could not build the xor filter");
+                }
+
+                std::fill(counts.begin(), counts.end(), 0);
+                std::fill(xor_masks.begin(), xor_masks.end(), 0);
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t k = hash_int(keys[i], m_seed);
+                    for (size_t b = 0; b < 3; ++b) {
+                        size_t pos = position(k, b);
+                        counts[pos] += 1;
+                        xor_masks[pos] ^= k;
+                    }
+                }
+
+                // peel the positions with a single key
+                queue.clear();
+                stack.clear();
+                for (size_t pos = 0; pos < size; ++pos) {
+                    if (counts[pos] == 1) queue.push_back(pos);
+                }
+                while (!queue.empty()) {
+                    size_t pos = queue.back();
+                    queue.pop_back();
+                    if (counts[pos] != 1) continue;
+                    uint64_t k = xor_masks[pos];
+                    stack.push_back(std::make_pair(pos, k));
+                    for (size_t b = 0; b < 3; ++b) {
+                        size_t other = position(k, b);
+                        counts[other] -= 1;
+                        xor_masks[other] ^= k;
+                        if (counts[other] == 1) queue.push_back(other);
+                    }
+                }
+
+                if (stack.size() == n) break;
+            }
+
+            // assign in reverse peeling order, so that the position of
+            // each key is the last one of its three to be set
+            std::vector<uint8_t> fingerprints(size);
+            for (size_t i = stack.size(); i != 0; --i) {
+                size_t pos = stack[i - 1].first;
+                uint64_t k = stack[i - 1].second;
+                fingerprints[pos] = 0;
+                fingerprints[pos] = fingerprint(k)
+                    ^ fingerprints[position(k, 0)]
+                    ^ fingerprints[position(k, 1)]
+                    ^ fingerprints[position(k, 2)];
+            }
+            mapper::mappable_vector<uint8_t>(fingerprints).swap(m_fingerprints);
+        }
+
+        uint64_t m_seed;
+        uint64_t m_block_length;
+        mapper::mappable_vector<uint8_t> m_fingerprints;
+    };
+
+}
+}